@@ -0,0 +1,79 @@
+// Per-sample cost of the non-uniformly partitioned convolution engine as the
+// impulse response grows, at a fixed 128-sample latency, and the worst block
+// time in the calling thread when fed at 10x real time, with the tail
+// computed inline and on the engine's worker thread.
+
+#include "dsp/convolution_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr size_t kNumSamples = 1 << 20;
+constexpr size_t kBlockSize = 256;
+constexpr size_t kHeadSize = 128;
+constexpr size_t kPacedSamples = 1 << 18;
+constexpr double kPacedRate = 48000.0 * 10.0;
+
+double nanosPerSample(ConvolutionEngine& engine, const std::vector<float>& input, std::vector<float>& output) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < kNumSamples; pos += kBlockSize) {
+        engine.process(&input[pos], &output[pos], kBlockSize);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() * 1e9 / kNumSamples;
+}
+
+// Worst single process() call, with blocks arriving at kPacedRate
+double peakBlockMicros(ConvolutionEngine& engine, const std::vector<float>& input, std::vector<float>& output) {
+    using Clock = std::chrono::steady_clock;
+    double peak = 0.0;
+    auto origin = Clock::now();
+    for (size_t pos = 0; pos < kPacedSamples; pos += kBlockSize) {
+        auto due = origin + std::chrono::duration<double>(pos / kPacedRate);
+        while (Clock::now() < due) {
+        }
+        auto start = Clock::now();
+        engine.process(&input[pos], &output[pos], kBlockSize);
+        peak = std::max(peak, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    return peak;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(kNumSamples);
+    for (auto& s : input) {
+        s = dist(rng);
+    }
+    std::vector<float> output(kNumSamples);
+
+    std::printf("%10s %8s %12s %12s %14s %14s\n", "ir", "stages", "ns/sample", "x realtime",
+                "peak us sync", "peak us async");
+
+    for (size_t irLength = 1024; irLength <= (1u << 20); irLength *= 4) {
+        std::vector<float> ir(irLength);
+        for (auto& s : ir) {
+            s = dist(rng) * 0.01f;
+        }
+        ConvolutionEngine engine(ir.data(), ir.size(), kHeadSize, 16384);
+        ConvolutionEngine asyncEngine(ir.data(), ir.size(), kHeadSize, 16384, true);
+
+        double ns = nanosPerSample(engine, input, output);
+        engine.reset();
+        double syncPeak = peakBlockMicros(engine, input, output);
+        double asyncPeak = peakBlockMicros(asyncEngine, input, output);
+        std::printf("%10zu %8zu %12.1f %12.0f %14.1f %14.1f\n", irLength, engine.getStages().size(),
+                    ns, 1e9 / (ns * 48000.0), syncPeak, asyncPeak);
+    }
+
+    return 0;
+}
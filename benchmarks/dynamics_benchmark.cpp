@@ -0,0 +1,243 @@
+// Compressor throughput against the original per-sample log10/pow gain
+// computer, and the worst-case gain difference between the two in dB;
+// then 64 tracks through separate Compressors and through a CompressorBank;
+// then the share of one core a stereo Limiter needs at 48 kHz, and the same
+// for a linked stereo Compressor against 3-5 band MultibandCompressors.
+
+#include "effects/compressor.h"
+#include "effects/compressor_bank.h"
+#include "effects/limiter.h"
+#include "effects/multiband_compressor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr size_t kNumSamples = 1 << 20;
+constexpr size_t kBlockSize = 512;
+constexpr int kIterations = 5;
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kNumTracks = 64;
+constexpr size_t kTrackSamples = 1 << 16;
+
+// The original Compressor::process, kept here as the baseline
+class ReferenceCompressor {
+public:
+    explicit ReferenceCompressor(const CompressorSettings& settings) : settings_(settings) {
+        attackCoeff_ = std::exp(-1.0f / (settings_.attack * kSampleRate / 1000.0f));
+        releaseCoeff_ = std::exp(-1.0f / (settings_.release * kSampleRate / 1000.0f));
+    }
+
+    void process(float* data, size_t numSamples) {
+        for (size_t i = 0; i < numSamples; ++i) {
+            float inputLevel = std::abs(data[i]);
+            if (inputLevel > envelope_) {
+                envelope_ = inputLevel + (envelope_ - inputLevel) * attackCoeff_;
+            } else {
+                envelope_ = inputLevel + (envelope_ - inputLevel) * releaseCoeff_;
+            }
+            float gain = computeGain(envelope_);
+            data[i] *= gain;
+            gainReduction_ = 20.0f * std::log10(gain);
+        }
+    }
+
+    float getGainReduction() const { return gainReduction_; }
+
+private:
+    CompressorSettings settings_;
+    float envelope_ = 0.0f;
+    float gainReduction_ = 0.0f;
+    float attackCoeff_;
+    float releaseCoeff_;
+
+    float computeGain(float inputLevel) {
+        float inputDb = 20.0f * std::log10(std::max(inputLevel, 1e-10f));
+        float kneeStart = settings_.threshold - settings_.knee / 2.0f;
+        float kneeEnd = settings_.threshold + settings_.knee / 2.0f;
+        float gainReduction = 0.0f;
+        if (inputDb > kneeEnd) {
+            gainReduction = (inputDb - settings_.threshold) * (1.0f - 1.0f / settings_.ratio);
+        } else if (inputDb > kneeStart) {
+            float kneeProgress = (inputDb - kneeStart) / settings_.knee;
+            gainReduction = (inputDb - settings_.threshold) * (1.0f - 1.0f / settings_.ratio) *
+                            kneeProgress * kneeProgress;
+        }
+        return std::pow(10.0f, (-gainReduction + settings_.makeupGain) / 20.0f);
+    }
+};
+
+template <typename Processor>
+double bestSeconds(Processor make, std::vector<float>& data, const std::vector<float>& source) {
+    double best = 1e30;
+    for (int it = 0; it < kIterations; ++it) {
+        auto processor = make();
+        data = source;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t pos = 0; pos < data.size(); pos += kBlockSize) {
+            processor.process(&data[pos], std::min(kBlockSize, data.size() - pos));
+        }
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    // Noise with a slow level sweep so the envelope crosses the knee
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> source(kNumSamples);
+    for (size_t i = 0; i < source.size(); ++i) {
+        float level = std::pow(10.0f, -3.0f * (0.5f + 0.5f * std::sin(static_cast<float>(i) * 1e-4f)));
+        source[i] = dist(rng) * level;
+    }
+
+    CompressorSettings settings;
+    settings.threshold = -24.0f;
+    settings.ratio = 4.0f;
+    settings.knee = 6.0f;
+    settings.makeupGain = 3.0f;
+
+    std::vector<float> refOut;
+    std::vector<float> newOut;
+    double refSeconds = bestSeconds([&] { return ReferenceCompressor(settings); }, refOut, source);
+    double newSeconds = bestSeconds([&] {
+        Compressor c(settings);
+        c.prepare(kSampleRate, kBlockSize);
+        return c;
+    }, newOut, source);
+
+    double maxErrDb = 0.0;
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (std::abs(source[i]) > 1e-6f) {
+            double gRef = static_cast<double>(refOut[i]) / source[i];
+            double gNew = static_cast<double>(newOut[i]) / source[i];
+            maxErrDb = std::max(maxErrDb, std::abs(20.0 * std::log10(gNew / gRef)));
+        }
+    }
+
+    std::printf("%-12s %12s\n", "compressor", "Ms/s");
+    std::printf("%-12s %12.1f\n", "log10/pow", kNumSamples / refSeconds * 1e-6);
+    std::printf("%-12s %12.1f\n", "log2 domain", kNumSamples / newSeconds * 1e-6);
+    std::printf("speedup %.2fx, max gain difference %.2e dB\n", refSeconds / newSeconds, maxErrDb);
+
+    // Per-track dynamics for a large session
+    std::vector<std::vector<float>> tracks(kNumTracks);
+    std::vector<float*> channels(kNumTracks);
+    for (size_t t = 0; t < kNumTracks; ++t) {
+        tracks[t].assign(source.begin() + t * 1024, source.begin() + t * 1024 + kTrackSamples);
+        channels[t] = tracks[t].data();
+    }
+
+    std::vector<Compressor> separate(kNumTracks, Compressor(settings));
+    CompressorBank bank(kNumTracks);
+    for (size_t t = 0; t < kNumTracks; ++t) {
+        separate[t].prepare(kSampleRate, kBlockSize);
+        bank.setSettings(t, settings);
+    }
+    bank.prepare(kSampleRate, kBlockSize);
+
+    auto timeTracks = [&](auto&& processBlock) {
+        double best = 1e30;
+        for (int it = 0; it < kIterations; ++it) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t pos = 0; pos < kTrackSamples; pos += kBlockSize) {
+                processBlock(pos);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best;
+    };
+
+    double separateSeconds = timeTracks([&](size_t pos) {
+        for (size_t t = 0; t < kNumTracks; ++t) {
+            separate[t].process(channels[t] + pos, kBlockSize);
+        }
+    });
+    double bankSeconds = timeTracks([&](size_t pos) {
+        std::vector<float*> block(kNumTracks);
+        for (size_t t = 0; t < kNumTracks; ++t) {
+            block[t] = channels[t] + pos;
+        }
+        bank.process(block.data(), kBlockSize);
+    });
+
+    const double trackSamples = static_cast<double>(kNumTracks * kTrackSamples);
+    std::printf("\n%zu tracks    %12s\n", kNumTracks, "Ms/s");
+    std::printf("%-12s %12.1f\n", "separate", trackSamples / separateSeconds * 1e-6);
+    std::printf("%-12s %12.1f\n", "bank", trackSamples / bankSeconds * 1e-6);
+    std::printf("speedup %.2fx\n", separateSeconds / bankSeconds);
+
+    // Stereo limiter load in real time
+    std::printf("\n%-12s %12s\n", "limiter", "% core");
+    for (bool truePeak : {false, true}) {
+        LimiterSettings limiterSettings;
+        limiterSettings.truePeak = truePeak;
+        Limiter limiter(limiterSettings);
+        limiter.prepare(kSampleRate, kBlockSize, 2);
+
+        std::vector<float> left(source.begin(), source.begin() + kTrackSamples);
+        std::vector<float> right(source.begin() + kTrackSamples, source.begin() + 2 * kTrackSamples);
+        for (size_t i = 0; i < kTrackSamples; ++i) {
+            left[i] *= 4.0f;
+            right[i] *= 4.0f;
+        }
+
+        double best = 1e30;
+        for (int it = 0; it < kIterations; ++it) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t pos = 0; pos < kTrackSamples; pos += kBlockSize) {
+                float* channels[] = {&left[pos], &right[pos]};
+                limiter.process(channels, 2, kBlockSize);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        double load = best / (kTrackSamples / kSampleRate) * 100.0;
+        std::printf("%-12s %12.3f\n", truePeak ? "true peak" : "sample peak", load);
+    }
+
+    // Stereo bus dynamics load in real time
+    auto stereoLoad = [&](auto& processor) {
+        std::vector<float> left(source.begin(), source.begin() + kTrackSamples);
+        std::vector<float> right(source.begin() + kTrackSamples, source.begin() + 2 * kTrackSamples);
+        double best = 1e30;
+        for (int it = 0; it < kIterations; ++it) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t pos = 0; pos < kTrackSamples; pos += kBlockSize) {
+                float* channels[] = {&left[pos], &right[pos]};
+                processor.process(channels, 2, kBlockSize);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best / (kTrackSamples / kSampleRate) * 100.0;
+    };
+
+    std::printf("\n%-12s %12s\n", "bus dynamics", "% core");
+    Compressor single(settings);
+    single.prepare(kSampleRate, kBlockSize);
+    std::printf("%-12s %12.3f\n", "1 band", stereoLoad(single));
+    for (size_t numBands = MultibandCompressor::kMinBands; numBands <= MultibandCompressor::kMaxBands; ++numBands) {
+        MultibandCompressor multiband(numBands);
+        multiband.prepare(kSampleRate, kBlockSize, 2);
+        for (size_t b = 0; b < numBands; ++b) {
+            multiband.setBandSettings(b, settings);
+        }
+        char label[16];
+        std::snprintf(label, sizeof(label), "%zu bands", numBands);
+        std::printf("%-12s %12.3f\n", label, stereoLoad(multiband));
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Compares one pass per band against the fused per-sample cascade and the
+// block-parallel kernel for 1-12 band equalizers on a single long channel.
+
+#include "effects/equalizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr size_t kNumSamples = 1 << 21;  // larger than L2 so per-band passes pay for bandwidth
+constexpr int kIterations = 5;
+
+EQBand makeBand(size_t index) {
+    EQBand band;
+    band.frequency = 60.0f * static_cast<float>(index + 1) * static_cast<float>(index + 1);
+    band.gain = (index % 2 == 0) ? 3.0f : -3.0f;
+    band.q = 1.0f;
+    return band;
+}
+
+template <typename Fn>
+double bestSeconds(std::vector<float>& data, const std::vector<float>& source, Fn&& fn) {
+    double best = 1e30;
+    for (int it = 0; it < kIterations; ++it) {
+        data = source;
+        auto start = std::chrono::steady_clock::now();
+        fn(data.data(), data.size());
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> source(kNumSamples);
+    for (auto& s : source) {
+        s = dist(rng);
+    }
+    std::vector<float> data;
+
+    std::printf("%6s %14s %14s %14s %9s\n", "bands", "per-band Ms/s", "fused Ms/s", "block Ms/s", "speedup");
+
+    for (size_t numBands = 1; numBands <= kMaxFusedBiquads; ++numBands) {
+        // Reference: one single-band equalizer per band, i.e. one pass per band
+        std::vector<Equalizer> perBand(numBands);
+        Equalizer fused;
+        Equalizer blockParallel;
+        blockParallel.setProcessingMode(Equalizer::ProcessingMode::BlockParallel);
+        for (size_t b = 0; b < numBands; ++b) {
+            perBand[b].setBand(0, makeBand(b));
+            fused.setBand(b, makeBand(b));
+            blockParallel.setBand(b, makeBand(b));
+        }
+
+        double perBandTime = bestSeconds(data, source, [&](float* d, size_t n) {
+            for (auto& eq : perBand) {
+                eq.process(d, n);
+            }
+        });
+        double fusedTime = bestSeconds(data, source, [&](float* d, size_t n) {
+            fused.process(d, n);
+        });
+        double blockTime = bestSeconds(data, source, [&](float* d, size_t n) {
+            blockParallel.process(d, n);
+        });
+
+        std::printf("%6zu %14.1f %14.1f %14.1f %8.2fx\n", numBands,
+                    kNumSamples / perBandTime * 1e-6,
+                    kNumSamples / fusedTime * 1e-6,
+                    kNumSamples / blockTime * 1e-6,
+                    perBandTime / std::min(fusedTime, blockTime));
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@ Setup script for AudioPractice package.
 from setuptools import setup, find_packages, Extension
 from pybind11.setup_helpers import Pybind11Extension, build_ext
 import glob
+import sys
 
 # Get all C++ source files
 cpp_sources = glob.glob("src/cpp/**/*.cpp", recursive=True)
@@ -18,6 +19,8 @@ ext_modules = [
         include_dirs=["src/cpp"],
         cxx_std=17,
         define_macros=[("VERSION_INFO", "1.0.0")],
+        # shm_open for shared-memory AudioBuffers
+        libraries=["rt"] if sys.platform.startswith("linux") else [],
     ),
 ]
 
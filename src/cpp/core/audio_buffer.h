@@ -4,52 +4,95 @@
 #include <memory>
 #include <cstring>
 #include <algorithm>
+#include <utility>
 #include <immintrin.h>
 
 namespace audio_practice {
 
+// Planar audio in one contiguous block: channel ch starts at
+// getData() + ch * getNumSamples(). The block is either allocated by the
+// buffer or borrowed from the caller (e.g. a numpy array), in which case the
+// owner handle keeps it alive for as long as any buffer refers to it.
+// Copies are deep and always own their storage; moves transfer the block.
 class AudioBuffer {
 public:
     AudioBuffer(size_t channels, size_t samples)
-        : channels_(channels), samples_(samples) {
-        data_.resize(channels);
-        for (auto& channel : data_) {
-            channel.resize(samples, 0.0f);
+        : channels_(channels), samples_(samples),
+          owner_(allocate(channels * samples)),
+          data_(static_cast<float*>(owner_.get())) {}
+
+    // Wrap existing planar data without copying. With a null owner the caller
+    // guarantees the memory outlives the buffer.
+    AudioBuffer(float* data, size_t channels, size_t samples,
+                std::shared_ptr<void> owner = nullptr)
+        : channels_(channels), samples_(samples), owner_(std::move(owner)), data_(data) {}
+
+    AudioBuffer(const AudioBuffer& other)
+        : channels_(other.channels_), samples_(other.samples_),
+          owner_(allocate(other.channels_ * other.samples_)),
+          data_(static_cast<float*>(owner_.get())) {
+        std::memcpy(data_, other.data_, channels_ * samples_ * sizeof(float));
+    }
+
+    AudioBuffer(AudioBuffer&& other) noexcept
+        : channels_(std::exchange(other.channels_, 0)),
+          samples_(std::exchange(other.samples_, 0)),
+          owner_(std::move(other.owner_)),
+          data_(std::exchange(other.data_, nullptr)) {}
+
+    AudioBuffer& operator=(const AudioBuffer& other) {
+        if (this != &other) {
+            *this = AudioBuffer(other);
         }
+        return *this;
+    }
+
+    AudioBuffer& operator=(AudioBuffer&& other) noexcept {
+        channels_ = std::exchange(other.channels_, 0);
+        samples_ = std::exchange(other.samples_, 0);
+        owner_ = std::move(other.owner_);
+        data_ = std::exchange(other.data_, nullptr);
+        return *this;
     }
 
     // Get raw pointer to channel data
     float* getChannelData(size_t channel) {
-        return data_[channel].data();
+        return data_ + channel * samples_;
     }
 
     const float* getChannelData(size_t channel) const {
-        return data_[channel].data();
+        return data_ + channel * samples_;
     }
 
+    // Start of the planar block
+    float* getData() { return data_; }
+    const float* getData() const { return data_; }
+
+    // Handle keeping the storage alive; share it to hand the samples to
+    // another owner without copying
+    const std::shared_ptr<void>& getOwner() const { return owner_; }
+
     // SIMD-optimized operations
     void applyGain(float gain) {
         const __m256 gain_vec = _mm256_set1_ps(gain);
+        const size_t total = channels_ * samples_;
         
-        for (auto& channel : data_) {
-            size_t i = 0;
-            for (; i + 8 <= channel.size(); i += 8) {
-                __m256 samples = _mm256_loadu_ps(&channel[i]);
-                samples = _mm256_mul_ps(samples, gain_vec);
-                _mm256_storeu_ps(&channel[i], samples);
-            }
-            
-            // Handle remaining samples
-            for (; i < channel.size(); ++i) {
-                channel[i] *= gain;
-            }
+        // Channels are contiguous, so the whole block is one pass
+        size_t i = 0;
+        for (; i + 8 <= total; i += 8) {
+            __m256 samples = _mm256_loadu_ps(&data_[i]);
+            samples = _mm256_mul_ps(samples, gain_vec);
+            _mm256_storeu_ps(&data_[i], samples);
+        }
+        
+        // Handle remaining samples
+        for (; i < total; ++i) {
+            data_[i] *= gain;
         }
     }
 
     void clear() {
-        for (auto& channel : data_) {
-            std::fill(channel.begin(), channel.end(), 0.0f);
-        }
+        std::fill(data_, data_ + channels_ * samples_, 0.0f);
     }
 
     size_t getNumChannels() const { return channels_; }
@@ -84,7 +127,12 @@ public:
 private:
     size_t channels_;
     size_t samples_;
-    std::vector<std::vector<float>> data_;
+    std::shared_ptr<void> owner_;
+    float* data_;
+
+    static std::shared_ptr<void> allocate(size_t count) {
+        return std::shared_ptr<float>(new float[count](), std::default_delete<float[]>());
+    }
 };
 
 } // namespace audio_practice 
\ No newline at end of file
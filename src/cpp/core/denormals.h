@@ -0,0 +1,28 @@
+#pragma once
+
+#include <immintrin.h>
+
+namespace audio_practice {
+
+// Sets flush-to-zero and denormals-are-zero on this thread for the guard's
+// lifetime. Decaying envelopes and IIR tails otherwise spend a long time in
+// the denormal range, where every operation is many times slower.
+class ScopedNoDenormals {
+public:
+    ScopedNoDenormals() : saved_(_mm_getcsr()) {
+        _mm_setcsr(saved_ | kFlushToZero | kDenormalsAreZero);
+    }
+    
+    ~ScopedNoDenormals() { _mm_setcsr(saved_); }
+    
+    ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+    ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+private:
+    static constexpr unsigned int kFlushToZero = 0x8000;
+    static constexpr unsigned int kDenormalsAreZero = 0x0040;
+    
+    unsigned int saved_;
+};
+
+} // namespace audio_practice
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+namespace audio_practice {
+
+// Sample types accepted from outside (files, numpy) and converted to float
+enum class SampleFormat {
+    Float32,
+    Float64,
+    Int16,
+    Int32
+};
+
+inline size_t getSampleSize(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Float64: return 8;
+        case SampleFormat::Int16: return 2;
+        default: return 4;
+    }
+}
+
+namespace detail {
+
+// Samples index..index + 7 of src as floats. Integer PCM maps full scale
+// to [-1, 1).
+template <SampleFormat Format>
+inline __m256 loadSamples8(const void* src, size_t index) {
+    if constexpr (Format == SampleFormat::Float32) {
+        return _mm256_loadu_ps(static_cast<const float*>(src) + index);
+    } else if constexpr (Format == SampleFormat::Float64) {
+        const double* in = static_cast<const double*>(src) + index;
+        return _mm256_set_m128(_mm256_cvtpd_ps(_mm256_loadu_pd(in + 4)),
+                               _mm256_cvtpd_ps(_mm256_loadu_pd(in)));
+    } else if constexpr (Format == SampleFormat::Int16) {
+        const int16_t* in = static_cast<const int16_t*>(src) + index;
+        __m256i wide = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(wide), _mm256_set1_ps(1.0f / 32768.0f));
+    } else {
+        const int32_t* in = static_cast<const int32_t*>(src) + index;
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(1.0f / 2147483648.0f));
+    }
+}
+
+template <SampleFormat Format>
+inline float loadSample(const void* src, size_t index) {
+    if constexpr (Format == SampleFormat::Float32) {
+        return static_cast<const float*>(src)[index];
+    } else if constexpr (Format == SampleFormat::Float64) {
+        return static_cast<float>(static_cast<const double*>(src)[index]);
+    } else if constexpr (Format == SampleFormat::Int16) {
+        return static_cast<float>(static_cast<const int16_t*>(src)[index]) * (1.0f / 32768.0f);
+    } else {
+        return static_cast<float>(static_cast<const int32_t*>(src)[index]) * (1.0f / 2147483648.0f);
+    }
+}
+
+// Frames i..i + 7 of channel ch from interleaved 32-bit samples
+template <SampleFormat Format>
+inline __m256 gatherSamples8(const void* src, size_t numChannels, size_t i, size_t ch,
+                             __m256i offsets) {
+    if constexpr (Format == SampleFormat::Float32) {
+        return _mm256_i32gather_ps(static_cast<const float*>(src) + i * numChannels + ch,
+                                   offsets, 4);
+    } else {
+        const int* in = static_cast<const int*>(src) + i * numChannels + ch;
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_i32gather_epi32(in, offsets, 4)),
+                             _mm256_set1_ps(1.0f / 2147483648.0f));
+    }
+}
+
+template <SampleFormat Format>
+inline void convertSamples(const void* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(&dst[i], loadSamples8<Format>(src, i));
+    }
+    for (; i < count; ++i) {
+        dst[i] = loadSample<Format>(src, i);
+    }
+}
+
+template <SampleFormat Format>
+inline void convertToPlanar(const void* src, size_t numChannels, size_t numFrames,
+                            bool interleaved, float* const* dst) {
+    if (!interleaved || numChannels == 1) {
+        const size_t sampleSize = getSampleSize(Format);
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            convertSamples<Format>(static_cast<const uint8_t*>(src) + ch * numFrames * sampleSize,
+                                   dst[ch], numFrames);
+        }
+        return;
+    }
+    
+    size_t i = 0;
+    if (numChannels == 2) {
+        // Convert 16 interleaved samples, then split them in registers.
+        // Per 128-bit lane the shuffle yields L0 L1 L4 L5 | L2 L3 L6 L7.
+        for (; i + 8 <= numFrames; i += 8) {
+            __m256 a = loadSamples8<Format>(src, 2 * i);      // L0 R0 .. L3 R3
+            __m256 b = loadSamples8<Format>(src, 2 * i + 8);  // L4 R4 .. L7 R7
+            __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0)));
+            r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(&dst[0][i], l);
+            _mm256_storeu_ps(&dst[1][i], r);
+        }
+    } else if constexpr (Format == SampleFormat::Float32 || Format == SampleFormat::Int32) {
+        // Strided gathers, one channel at a time
+        const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                   _mm256_set1_epi32(static_cast<int>(numChannels)));
+        for (; i + 8 <= numFrames; i += 8) {
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                _mm256_storeu_ps(&dst[ch][i], gatherSamples8<Format>(src, numChannels, i, ch, offsets));
+            }
+        }
+    } else {
+        // 16- and 64-bit samples: convert a cache-sized chunk to float,
+        // then split it with the float gathers
+        constexpr size_t kChunkSamples = 4096;
+        constexpr size_t kMaxChunkChannels = 64;
+        if (numChannels <= kMaxChunkChannels) {
+            alignas(32) float chunk[kChunkSamples];
+            float* out[kMaxChunkChannels];
+            const size_t framesPerChunk = kChunkSamples / numChannels;
+            for (; i < numFrames; i += framesPerChunk) {
+                const size_t frames = std::min(framesPerChunk, numFrames - i);
+                convertSamples<Format>(static_cast<const uint8_t*>(src) +
+                                       i * numChannels * getSampleSize(Format),
+                                       chunk, frames * numChannels);
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    out[ch] = dst[ch] + i;
+                }
+                convertToPlanar<SampleFormat::Float32>(chunk, numChannels, frames, true, out);
+            }
+        }
+    }
+    
+    for (; i < numFrames; ++i) {
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            dst[ch][i] = loadSample<Format>(src, i * numChannels + ch);
+        }
+    }
+}
+
+} // namespace detail
+
+// Convert count contiguous samples to float, 8 per step
+inline void convertSamples(const void* src, SampleFormat format, float* dst, size_t count) {
+    switch (format) {
+        case SampleFormat::Float32:
+            std::memcpy(dst, src, count * sizeof(float));
+            break;
+        case SampleFormat::Float64:
+            detail::convertSamples<SampleFormat::Float64>(src, dst, count);
+            break;
+        case SampleFormat::Int16:
+            detail::convertSamples<SampleFormat::Int16>(src, dst, count);
+            break;
+        case SampleFormat::Int32:
+            detail::convertSamples<SampleFormat::Int32>(src, dst, count);
+            break;
+    }
+}
+
+// Convert planar (channel after channel) or interleaved (frame after frame)
+// samples into planar float channels in one pass. Stereo is converted and
+// split in registers; other channel counts use strided gathers.
+inline void convertToPlanar(const void* src, SampleFormat format, size_t numChannels,
+                            size_t numFrames, bool interleaved, float* const* dst) {
+    switch (format) {
+        case SampleFormat::Float32:
+            detail::convertToPlanar<SampleFormat::Float32>(src, numChannels, numFrames, interleaved, dst);
+            break;
+        case SampleFormat::Float64:
+            detail::convertToPlanar<SampleFormat::Float64>(src, numChannels, numFrames, interleaved, dst);
+            break;
+        case SampleFormat::Int16:
+            detail::convertToPlanar<SampleFormat::Int16>(src, numChannels, numFrames, interleaved, dst);
+            break;
+        case SampleFormat::Int32:
+            detail::convertToPlanar<SampleFormat::Int32>(src, numChannels, numFrames, interleaved, dst);
+            break;
+    }
+}
+
+} // namespace audio_practice
@@ -0,0 +1,62 @@
+#pragma once
+
+#if defined(__linux__)
+#include <semaphore.h>
+#else
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#endif
+
+namespace audio_practice {
+
+// Counting semaphore for waking a worker from a real-time thread. On Linux
+// it is an unnamed POSIX semaphore: post() never allocates or blocks, and is
+// a futex that only enters the kernel when a thread is asleep on it.
+// Elsewhere a mutex and condition variable stand in, so post() takes a
+// short lock.
+class Semaphore {
+public:
+#if defined(__linux__)
+    Semaphore() { sem_init(&sem_, 0, 0); }
+    ~Semaphore() { sem_destroy(&sem_); }
+
+    void post() { sem_post(&sem_); }
+
+    void wait() {
+        while (sem_wait(&sem_) != 0) {
+            // Interrupted by a signal; keep waiting
+        }
+    }
+#else
+    Semaphore() = default;
+
+    void post() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++count_;
+        }
+        available_.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [this] { return count_ > 0; });
+        --count_;
+    }
+#endif
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+private:
+#if defined(__linux__)
+    sem_t sem_;
+#else
+    std::mutex mutex_;
+    std::condition_variable available_;
+    size_t count_ = 0;
+#endif
+};
+
+} // namespace audio_practice
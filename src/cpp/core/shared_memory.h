@@ -0,0 +1,245 @@
+#pragma once
+
+#include "core/audio_buffer.h"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace audio_practice {
+
+// Planar float samples in a named POSIX shared-memory segment, so several
+// processes map the same audio without copying or serializing it. The
+// segment starts with a small header recording the shape, followed by the
+// samples (64-byte aligned). AudioBuffers use a segment as their storage
+// owner through createSharedAudioBuffer/openSharedAudioBuffer below.
+//
+// The header also counts references across processes. Every segment object
+// that created or opened the name holds one, and retain() adds one for a
+// handle on its way to another process (e.g. a pickled buffer), which the
+// receiver takes over with adopt(). The name is unlinked when the count
+// drops to zero, so a worker can return a buffer it created and exit before
+// the parent attaches. Existing mappings stay valid after the unlink.
+class SharedAudioSegment {
+public:
+    // Create a new zeroed segment; fails if the name is already in use
+    static std::shared_ptr<SharedAudioSegment> create(const std::string& name,
+                                                      size_t channels, size_t samples) {
+        const std::string path = toPath(name);
+        int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + path);
+        }
+
+        if (samples != 0 && channels > (SIZE_MAX - kHeaderSize) / sizeof(float) / samples) {
+            close(fd);
+            shm_unlink(path.c_str());
+            throw std::length_error("Shared audio segment too large");
+        }
+        const size_t size = kHeaderSize + channels * samples * sizeof(float);
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const int error = errno;
+            close(fd);
+            shm_unlink(path.c_str());
+            throw std::system_error(error, std::generic_category(), "ftruncate " + path);
+        }
+
+        std::shared_ptr<SharedAudioSegment> segment(new SharedAudioSegment(path, fd, size, true),
+                                                    Deleter());
+        Header* header = new (segment->base_) Header();
+        header->references.store(1, std::memory_order_relaxed);
+        segment->ownerPid_ = getpid();
+        header->channels = channels;
+        header->samples = samples;
+        header->version = kVersion;
+        header->magic = kMagic;  // last, so a complete header is recognizable
+        return segment;
+    }
+
+    // Map an existing segment created by any process, taking a new reference.
+    // Fails once the name is being released.
+    static std::shared_ptr<SharedAudioSegment> open(const std::string& name) {
+        std::shared_ptr<SharedAudioSegment> segment = map(name);
+        std::atomic<uint32_t>& references = segment->header()->references;
+        uint32_t count = references.load(std::memory_order_relaxed);
+        do {
+            if (count == 0) {
+                throw std::system_error(ENOENT, std::generic_category(),
+                                        "shm_open " + segment->path_);
+            }
+        } while (!references.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+        segment->ownerPid_ = getpid();
+        return segment;
+    }
+
+    // Map a segment and take over a reference added by retain(), possibly in
+    // another process. Each retain() is matched by exactly one adopt().
+    static std::shared_ptr<SharedAudioSegment> adopt(const std::string& name) {
+        std::shared_ptr<SharedAudioSegment> segment = map(name);
+        segment->ownerPid_ = getpid();
+        return segment;
+    }
+
+    ~SharedAudioSegment() {
+        // Forked children inherit the object but not its reference
+        if (ownerPid_ == getpid() &&
+            header()->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            shm_unlink(path_.c_str());
+        }
+        munmap(base_, size_);
+    }
+
+    SharedAudioSegment(const SharedAudioSegment&) = delete;
+    SharedAudioSegment& operator=(const SharedAudioSegment&) = delete;
+
+    // Add a reference for a handle passed to another process, keeping the
+    // name alive until the receiver adopt()s it
+    void retain() { header()->references.fetch_add(1, std::memory_order_relaxed); }
+
+    // Remove the name now, e.g. to discard references that will never be
+    // adopted. Existing mappings stay valid.
+    void unlink() { shm_unlink(path_.c_str()); }
+
+    const std::string& getName() const { return path_; }
+    size_t getNumChannels() const { return header()->channels; }
+    size_t getNumSamples() const { return header()->samples; }
+    uint32_t getReferenceCount() const { return header()->references.load(std::memory_order_relaxed); }
+    float* getData() { return reinterpret_cast<float*>(static_cast<uint8_t*>(base_) + kHeaderSize); }
+
+    // Deleter tagging shared_ptrs that own a segment, so a buffer's storage
+    // owner can be recognized as one (see getSharedSegment)
+    struct Deleter {
+        void operator()(SharedAudioSegment* segment) const { delete segment; }
+    };
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t channels;
+        uint64_t samples;
+        std::atomic<uint32_t> references;
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "the reference count must work across processes");
+
+    static constexpr uint32_t kMagic = 0x41504142;  // "BAPA"
+    static constexpr uint32_t kVersion = 2;
+    static constexpr size_t kHeaderSize = 64;
+
+    std::string path_;
+    void* base_;
+    size_t size_;
+    pid_t ownerPid_ = -1;  // process holding this object's reference, if any
+
+    // Map an existing segment and validate its header
+    static std::shared_ptr<SharedAudioSegment> map(const std::string& name) {
+        const std::string path = toPath(name);
+        int fd = shm_open(path.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + path);
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path);
+        }
+        if (static_cast<size_t>(info.st_size) < kHeaderSize) {
+            close(fd);
+            throw std::invalid_argument(path + " is not an audio segment");
+        }
+
+        std::shared_ptr<SharedAudioSegment> segment(
+            new SharedAudioSegment(path, fd, static_cast<size_t>(info.st_size), false), Deleter());
+        const Header* header = segment->header();
+        // Division keeps a corrupt shape from overflowing the size check
+        const size_t capacity = (segment->size_ - kHeaderSize) / sizeof(float);
+        if (header->magic != kMagic || header->version != kVersion ||
+            (header->samples != 0 && header->channels > capacity / header->samples)) {
+            throw std::invalid_argument(path + " is not an audio segment");
+        }
+        return segment;
+    }
+
+    // Takes over fd; the mapping keeps the segment alive without it
+    SharedAudioSegment(std::string path, int fd, size_t size, bool creator)
+        : path_(std::move(path)), size_(size) {
+        base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        close(fd);
+        if (base_ == MAP_FAILED) {
+            if (creator) {
+                shm_unlink(path_.c_str());
+            }
+            throw std::system_error(error, std::generic_category(), "mmap " + path_);
+        }
+    }
+
+    Header* header() { return static_cast<Header*>(base_); }
+    const Header* header() const { return static_cast<const Header*>(base_); }
+
+    // POSIX names are a single leading slash followed by the name
+    static std::string toPath(const std::string& name) {
+        if (name.empty() || name.find('/', 1) != std::string::npos) {
+            throw std::invalid_argument("Invalid shared memory name: " + name);
+        }
+        return name[0] == '/' ? name : "/" + name;
+    }
+};
+
+namespace detail {
+
+inline AudioBuffer wrapSegment(std::shared_ptr<SharedAudioSegment> segment) {
+    float* data = segment->getData();
+    const size_t channels = segment->getNumChannels();
+    const size_t samples = segment->getNumSamples();
+    return AudioBuffer(data, channels, samples, std::move(segment));
+}
+
+} // namespace detail
+
+// Buffer in a new named shared-memory segment, zeroed. Other processes map
+// the same samples with openSharedAudioBuffer(name); the name is released
+// once no process holds a reference.
+inline AudioBuffer createSharedAudioBuffer(const std::string& name, size_t channels, size_t samples) {
+    return detail::wrapSegment(SharedAudioSegment::create(name, channels, samples));
+}
+
+// Attach to a segment made by createSharedAudioBuffer in any process
+inline AudioBuffer openSharedAudioBuffer(const std::string& name) {
+    return detail::wrapSegment(SharedAudioSegment::open(name));
+}
+
+// Attach and take over a reference handed over with SharedAudioSegment::retain()
+inline AudioBuffer adoptSharedAudioBuffer(const std::string& name) {
+    return detail::wrapSegment(SharedAudioSegment::adopt(name));
+}
+
+// Segment whose samples the buffer covers exactly, or null when the buffer
+// is private storage or only a view into part of a segment
+inline std::shared_ptr<SharedAudioSegment> getSharedSegment(const AudioBuffer& buffer) {
+    const std::shared_ptr<void>& owner = buffer.getOwner();
+    if (!std::get_deleter<SharedAudioSegment::Deleter>(owner)) {
+        return nullptr;
+    }
+    auto segment = std::static_pointer_cast<SharedAudioSegment>(owner);
+    if (segment->getData() != buffer.getData() ||
+        segment->getNumChannels() != buffer.getNumChannels() ||
+        segment->getNumSamples() != buffer.getNumSamples()) {
+        return nullptr;
+    }
+    return segment;
+}
+
+} // namespace audio_practice
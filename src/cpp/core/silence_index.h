@@ -0,0 +1,155 @@
+#pragma once
+
+#include "core/audio_buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <vector>
+
+namespace audio_practice {
+
+// Block-granular index of the silent parts of a track, built in one
+// vectorized max-abs pass. A block is silent when every sample of every
+// channel is at or below the threshold. Mixing, metering and analysis use it
+// to skip dead air; anything with state (e.g. IIR filters) still has to run
+// over silent blocks until its tail has decayed.
+class SilenceIndex {
+public:
+    static constexpr size_t kDefaultBlockSize = 256;
+    static constexpr float kDefaultThreshold = 3.1623e-5f;  // -90 dBFS
+    
+    // A run of silent samples
+    struct Region {
+        size_t start;
+        size_t length;
+    };
+    
+    SilenceIndex() = default;
+    
+    SilenceIndex(const float* const* channels, size_t numChannels, size_t numSamples,
+                 float threshold = kDefaultThreshold, size_t blockSize = kDefaultBlockSize) {
+        build(channels, numChannels, numSamples, threshold, blockSize);
+    }
+    
+    explicit SilenceIndex(const AudioBuffer& buffer, float threshold = kDefaultThreshold,
+                          size_t blockSize = kDefaultBlockSize) {
+        std::vector<const float*> channels(buffer.getNumChannels());
+        for (size_t ch = 0; ch < channels.size(); ++ch) {
+            channels[ch] = buffer.getChannelData(ch);
+        }
+        build(channels.data(), channels.size(), buffer.getNumSamples(), threshold, blockSize);
+    }
+    
+    void build(const float* const* channels, size_t numChannels, size_t numSamples,
+               float threshold = kDefaultThreshold, size_t blockSize = kDefaultBlockSize) {
+        blockSize_ = blockSize;
+        numSamples_ = numSamples;
+        threshold_ = threshold;
+        const size_t numBlocks = (numSamples + blockSize - 1) / blockSize;
+        silent_.assign(numBlocks, 0);
+        
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        for (size_t b = 0; b < numBlocks; ++b) {
+            const size_t start = b * blockSize;
+            const size_t end = std::min(start + blockSize, numSamples);
+            
+            __m256 peak = _mm256_setzero_ps();
+            float tailPeak = 0.0f;
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                const float* data = channels[ch];
+                size_t i = start;
+                for (; i + 8 <= end; i += 8) {
+                    peak = _mm256_max_ps(peak, _mm256_and_ps(_mm256_loadu_ps(&data[i]), absMask));
+                }
+                for (; i < end; ++i) {
+                    tailPeak = std::max(tailPeak, std::abs(data[i]));
+                }
+            }
+            
+            // Horizontal max
+            __m128 m = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+            m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+            m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+            silent_[b] = std::max(_mm_cvtss_f32(m), tailPeak) <= threshold;
+        }
+        indexRuns();
+    }
+    
+    // Also treat the blocks set in `blocks` as silent, e.g. where a gate
+    // closed after the index was built. Entries past the end are ignored.
+    void markSilent(const std::vector<uint8_t>& blocks) {
+        const size_t count = std::min(blocks.size(), silent_.size());
+        for (size_t b = 0; b < count; ++b) {
+            silent_[b] |= blocks[b] != 0;
+        }
+        indexRuns();
+    }
+    
+    float getThreshold() const { return threshold_; }
+    size_t getBlockSize() const { return blockSize_; }
+    size_t getNumBlocks() const { return silent_.size(); }
+    size_t getNumSamples() const { return numSamples_; }
+    size_t getNumSilentBlocks() const { return silentBefore_.empty() ? 0 : silentBefore_.back(); }
+    
+    bool isSilentBlock(size_t block) const { return silent_[block] != 0; }
+    
+    // True when every block overlapping [start, start + length) is silent;
+    // samples past the end count as silent
+    bool isSilent(size_t start, size_t length) const {
+        if (length == 0 || start >= numSamples_) {
+            return true;
+        }
+        const size_t first = start / blockSize_;
+        const size_t last = (std::min(start + length, numSamples_) - 1) / blockSize_;
+        return silentBefore_[last + 1] - silentBefore_[first] == last - first + 1;
+    }
+    
+    // Maximal runs of silent samples, in order
+    const std::vector<Region>& getSilentRegions() const { return regions_; }
+    
+    // Call fn(start, length) for each maximal run of non-silent samples
+    template <typename Fn>
+    void forEachActiveRegion(Fn&& fn) const {
+        size_t pos = 0;
+        for (const Region& region : regions_) {
+            if (region.start > pos) {
+                fn(pos, region.start - pos);
+            }
+            pos = region.start + region.length;
+        }
+        if (pos < numSamples_) {
+            fn(pos, numSamples_ - pos);
+        }
+    }
+
+private:
+    float threshold_ = kDefaultThreshold;
+    size_t blockSize_ = kDefaultBlockSize;
+    size_t numSamples_ = 0;
+    std::vector<uint8_t> silent_;
+    std::vector<size_t> silentBefore_;  // silent blocks before each block
+    std::vector<Region> regions_;
+    
+    // Rebuild silentBefore_ and regions_ from silent_
+    void indexRuns() {
+        silentBefore_.assign(silent_.size() + 1, 0);
+        regions_.clear();
+        for (size_t b = 0; b < silent_.size(); ++b) {
+            silentBefore_[b + 1] = silentBefore_[b] + silent_[b];
+            if (!silent_[b]) {
+                continue;
+            }
+            const size_t start = b * blockSize_;
+            const size_t end = std::min(start + blockSize_, numSamples_);
+            if (!regions_.empty() && regions_.back().start + regions_.back().length == start) {
+                regions_.back().length += end - start;
+            } else {
+                regions_.push_back({start, end - start});
+            }
+        }
+    }
+};
+
+} // namespace audio_practice
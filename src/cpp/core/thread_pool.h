@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace audio_practice {
+
+// Fixed set of worker threads draining a FIFO task queue
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads = std::max(1u, std::thread::hardware_concurrency())) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    // Finishes queued tasks before joining
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        available_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename Fn>
+    std::future<void> submit(Fn&& fn) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<Fn>(fn));
+        std::future<void> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([task] { (*task)(); });
+        }
+        available_.notify_one();
+        return result;
+    }
+
+    size_t getNumThreads() const { return workers_.size(); }
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    bool stopping_ = false;
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+} // namespace audio_practice
@@ -1,5 +1,10 @@
 #include "dsp/auto_mixer.h"
+#include "core/denormals.h"
+#include "core/thread_pool.h"
+#include "dsp/biquad.h"
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <numeric>
 #include <algorithm>
 
@@ -8,15 +13,44 @@ namespace audio_practice {
 void AutoMixer::initializeProcessors() {
     analyzer_ = std::make_unique<SpectrumAnalyzer>(2048);
     mixBusCompressor_ = std::make_unique<Compressor>();
+    mixBusCompressor_->prepare(settings_.sampleRate, 0);
+    mixBusCompressor_->setLinkMode(Compressor::LinkMode::Max);
+    
+    duckingCompressor_ = std::make_unique<Compressor>();
+    duckingCompressor_->prepare(settings_.sampleRate, 0);
+    duckingCompressor_->setLinkMode(Compressor::LinkMode::Max);
+    
+    LimiterSettings limiterSettings;
+    limiterSettings.ceiling = settings_.mixBusCeiling;
+    mixBusLimiter_ = std::make_unique<Limiter>(limiterSettings);
+    mixBusLimiter_->prepare(settings_.sampleRate, 0, 2);
 }
 
 AudioBuffer AutoMixer::process(const std::vector<AudioBuffer>& tracks) {
     if (tracks.empty()) {
         return AudioBuffer(2, 0);
     }
+    
+    ScopedNoDenormals noDenormals;
 
+    // Gate before analysis, so metering and spectra skip the bleed the
+    // gates close on as well as mixing does
+    std::vector<AudioBuffer> gated;
+    if (settings_.enableGate) {
+        while (trackGates_.size() < tracks.size()) {
+            trackGates_.push_back(std::make_unique<Gate>());
+            trackGates_.back()->prepare(settings_.sampleRate, 0);
+        }
+        gated.reserve(tracks.size());
+        trackSilence_.resize(tracks.size());
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            gated.push_back(tracks[i]);
+            gateTrack(i, gated.back());
+        }
+    }
+    
     // Analyze all tracks
-    auto mixParams = analyzeTracks(tracks);
+    auto mixParams = gated.empty() ? analyzeTracks(tracks) : analyzeIndexedTracks(gated);
     
     // Create output buffer
     size_t maxSamples = 0;
@@ -26,62 +60,357 @@ AudioBuffer AutoMixer::process(const std::vector<AudioBuffer>& tracks) {
     
     AudioBuffer mixBus(2, maxSamples);
     
+    // Voice tracks are summed separately so they can drive the ducker
+    const bool ducking = settings_.enableDucking && duckingCompressor_ &&
+                         !settings_.voiceTracks.empty();
+    const size_t lookahead = ducking
+        ? static_cast<size_t>(settings_.duckingLookahead * settings_.sampleRate / 1000.0f) : 0;
+    AudioBuffer voiceBus(2, ducking ? maxSamples + lookahead : 0);
+    
+    while (trackEQs_.size() < tracks.size()) {
+        trackEQs_.push_back(std::make_unique<Equalizer>());
+    }
+    
     // Process and mix each track
+    std::vector<uint8_t> skipBlocks;
     for (size_t i = 0; i < tracks.size(); ++i) {
-        AudioBuffer trackCopy = tracks[i];
+        AudioBuffer trackCopy = gated.empty() ? AudioBuffer(tracks[i]) : std::move(gated[i]);
+        processTrack(i, trackCopy, mixParams.trackGains[i], mixParams.trackEQs[i], skipBlocks);
         
-        // Apply gain
-        trackCopy.applyGain(mixParams.trackGains[i]);
+        float pan = settings_.enableSpatialProcessing ? mixParams.panPositions[i] : 0.0f;
+        mixTrack(ducking && isVoiceTrack(i) ? voiceBus : mixBus, trackCopy, pan, skipBlocks);
+    }
+    
+    if (ducking) {
+        duckUnderVoice(mixBus, voiceBus, mixParams.duckingCompressor, lookahead);
+        mixBus.addFrom(voiceBus);
+    }
+    
+    // Apply mix bus compression, linked across channels
+    if (mixBusCompressor_) {
+        mixBusCompressor_->setSettings(mixParams.mixBusCompressor);
+        mixBusCompressor_->reset();
         
-        // Apply EQ if enabled
-        if (settings_.enableDynamicEQ && !mixParams.trackEQs[i].empty()) {
-            // EQ processing would go here
+        std::vector<float*> channels(mixBus.getNumChannels());
+        for (size_t ch = 0; ch < channels.size(); ++ch) {
+            channels[ch] = mixBus.getChannelData(ch);
         }
+        mixBusCompressor_->process(channels.data(), channels.size(), mixBus.getNumSamples());
+    }
+    
+    // Track gains and summing can push the bus over full scale
+    if (mixBusLimiter_) {
+        limitMixBus(mixBus);
+    }
+    
+    return mixBus;
+}
+
+std::vector<AudioBuffer> AutoMixer::processBatch(
+    const std::vector<std::vector<AudioBuffer>>& sessions,
+    const AutoMixerSettings& settings, size_t numThreads) {
+    std::vector<AudioBuffer> results;
+    results.reserve(sessions.size());
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        results.emplace_back(2, 0);
+    }
+    if (sessions.empty()) {
+        return results;
+    }
+    
+    std::unique_ptr<ThreadPool> ownPool;
+    if (numThreads > 0) {
+        ownPool = std::make_unique<ThreadPool>(numThreads);
+    }
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+    
+    // Workers pull the next session until none are left, so long and short
+    // sessions balance out
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        AutoMixer mixer(settings);
+        for (size_t i = next++; i < sessions.size(); i = next++) {
+            results[i] = mixer.process(sessions[i]);
+        }
+    };
+    
+    const size_t numWorkers = std::min(pool.getNumThreads(), sessions.size());
+    std::vector<std::future<void>> pending;
+    for (size_t w = 0; w < numWorkers; ++w) {
+        pending.push_back(pool.submit(worker));
+    }
+    
+    // Wait for every worker before rethrowing, since they reference locals
+    std::exception_ptr error;
+    for (auto& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    
+    return results;
+}
+
+void AutoMixer::gateTrack(size_t index, AudioBuffer& track) {
+    const size_t numChannels = track.getNumChannels();
+    const size_t numSamples = track.getNumSamples();
+    const size_t blockSize = Gate::kHintBlockSize;
+    
+    std::vector<float*> channels(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = track.getChannelData(ch);
+    }
+    SilenceIndex& silence = trackSilence_[index];
+    silence.build(channels.data(), numChannels, numSamples,
+                  SilenceIndex::kDefaultThreshold, blockSize);
+    
+    Gate& gate = *trackGates_[index];
+    GateSettings gateSettings;
+    gateSettings.threshold = settings_.gateThreshold;
+    gate.setSettings(gateSettings);
+    gate.reset();
+    gate.process(channels.data(), numChannels, numSamples, &silence);
+    
+    // Blocks the gate held at the range floor become silence
+    const std::vector<uint8_t>& closed = gate.getClosedBlocks();
+    for (size_t b = 0; b < closed.size(); ++b) {
+        if (closed[b]) {
+            const size_t start = b * blockSize;
+            const size_t end = std::min(start + blockSize, numSamples);
+            for (float* data : channels) {
+                std::fill(data + start, data + end, 0.0f);
+            }
+        }
+    }
+    silence.markSilent(closed);
+}
+
+void AutoMixer::processTrack(size_t index, AudioBuffer& track, float gain,
+                             const std::vector<EQBand>& eqBands, std::vector<uint8_t>& skipBlocks) {
+    const size_t numChannels = track.getNumChannels();
+    const size_t numSamples = track.getNumSamples();
+    const size_t blockSize = Gate::kHintBlockSize;
+    
+    track.applyGain(gain);
+    
+    std::vector<float*> channels(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = track.getChannelData(ch);
+    }
+    
+    // Dead air after the gain, including blocks the gate zeroed, becomes
+    // silence
+    SilenceIndex silence(channels.data(), numChannels, numSamples,
+                         SilenceIndex::kDefaultThreshold, blockSize);
+    skipBlocks.assign(silence.getNumBlocks(), 0);
+    for (size_t b = 0; b < skipBlocks.size(); ++b) {
+        skipBlocks[b] = silence.isSilentBlock(b);
+    }
+    
+    bool anySkipped = false;
+    for (size_t b = 0; b < skipBlocks.size(); ++b) {
+        if (skipBlocks[b]) {
+            anySkipped = true;
+            const size_t start = b * blockSize;
+            const size_t end = std::min(start + blockSize, numSamples);
+            for (float* data : channels) {
+                std::fill(data + start, data + end, 0.0f);
+            }
+        }
+    }
+    
+    if (settings_.enableDynamicEQ && !eqBands.empty()) {
+        // Bands go in before prepare(), which resolves them through the
+        // shared coefficient cache
+        Equalizer& eq = *trackEQs_[index];
+        eq.clearBands();
+        for (size_t b = 0; b < eqBands.size(); ++b) {
+            eq.setBand(b, eqBands[b]);
+        }
+        eq.prepare(settings_.sampleRate, numSamples);
         
-        // Apply panning if enabled
-        if (settings_.enableSpatialProcessing) {
-            // Pan processing would go here
+        for (float* data : channels) {
+            eq.reset();
+            if (!anySkipped) {
+                eq.process(data, numSamples);
+                continue;
+            }
+            
+            // Silent blocks are skipped once the filters have rung out;
+            // until then the tail is rendered and the block is mixed
+            for (size_t b = 0; b < skipBlocks.size(); ++b) {
+                if (skipBlocks[b] && eq.isQuiescent()) {
+                    continue;
+                }
+                const size_t start = b * blockSize;
+                eq.process(data + start, std::min(blockSize, numSamples - start));
+                skipBlocks[b] = 0;
+            }
         }
+    }
+}
+
+void AutoMixer::mixTrack(AudioBuffer& bus, const AudioBuffer& track, float pan,
+                         const std::vector<uint8_t>& skipBlocks) {
+    const size_t numChannels = track.getNumChannels();
+    const size_t numSamples = std::min(bus.getNumSamples(), track.getNumSamples());
+    const size_t blockSize = Gate::kHintBlockSize;
+    if (numChannels == 0) {
+        return;
+    }
+    
+    float gains[2];
+    computePanGains(pan, numChannels, gains);
+    
+    for (size_t out = 0; out < std::min<size_t>(bus.getNumChannels(), 2); ++out) {
+        const float* src = track.getChannelData(numChannels == 1 ? 0 : out);
+        float* dst = bus.getChannelData(out);
+        const __m256 gain = _mm256_set1_ps(gains[out]);
         
-        // Add to mix bus
-        mixBus.addFrom(trackCopy);
+        for (size_t b = 0; b * blockSize < numSamples; ++b) {
+            if (skipBlocks[b]) {
+                continue;
+            }
+            const size_t end = std::min((b + 1) * blockSize, numSamples);
+            size_t i = b * blockSize;
+            for (; i + 8 <= end; i += 8) {
+                __m256 sum = _mm256_fmadd_ps(_mm256_loadu_ps(&src[i]), gain, _mm256_loadu_ps(&dst[i]));
+                _mm256_storeu_ps(&dst[i], sum);
+            }
+            for (; i < end; ++i) {
+                dst[i] += src[i] * gains[out];
+            }
+        }
+    }
+}
+
+void AutoMixer::computePanGains(float pan, size_t numChannels, float gains[2]) {
+    if (numChannels == 1) {
+        float angle = (pan + 1.0f) * static_cast<float>(M_PI) / 4.0f;
+        gains[0] = std::cos(angle);
+        gains[1] = std::sin(angle);
+    } else {
+        gains[0] = std::min(1.0f, 1.0f - pan);
+        gains[1] = std::min(1.0f, 1.0f + pan);
     }
+}
+
+bool AutoMixer::isVoiceTrack(size_t index) const {
+    return std::find(settings_.voiceTracks.begin(), settings_.voiceTracks.end(), index) !=
+           settings_.voiceTracks.end();
+}
+
+void AutoMixer::duckUnderVoice(AudioBuffer& musicBus, const AudioBuffer& voiceBus,
+                               const CompressorSettings& settings, size_t lookahead) {
+    const size_t numChannels = musicBus.getNumChannels();
     
-    // Apply mix bus compression
-    if (mixBusCompressor_) {
-        // Compression would go here
+    // The sidechain is a view into the voice bus, offset by the lookahead;
+    // the voice bus carries lookahead trailing zeros so the view stays in range
+    std::vector<float*> channels(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = musicBus.getChannelData(ch);
+    }
+    std::vector<const float*> sidechain(voiceBus.getNumChannels());
+    for (size_t ch = 0; ch < sidechain.size(); ++ch) {
+        sidechain[ch] = voiceBus.getChannelData(ch) + lookahead;
     }
     
-    return mixBus;
+    duckingCompressor_->setSettings(settings);
+    duckingCompressor_->reset();
+    duckingCompressor_->process(sidechain.data(), sidechain.size(),
+                                channels.data(), numChannels, musicBus.getNumSamples());
+}
+
+void AutoMixer::limitMixBus(AudioBuffer& mixBus) {
+    const size_t numChannels = mixBus.getNumChannels();
+    const size_t numSamples = mixBus.getNumSamples();
+    const size_t latency = mixBusLimiter_->getLatency();
+    
+    mixBusLimiter_->reset();
+    std::vector<float*> channels(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = mixBus.getChannelData(ch);
+    }
+    mixBusLimiter_->process(channels.data(), numChannels, numSamples);
+    
+    // Flush the last `latency` samples out with silence and shift the
+    // result back into alignment with the input
+    AudioBuffer tail(numChannels, latency);
+    std::vector<float*> tailChannels(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        tailChannels[ch] = tail.getChannelData(ch);
+    }
+    mixBusLimiter_->process(tailChannels.data(), numChannels, latency);
+    
+    const size_t shift = std::min(latency, numSamples);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        float* data = channels[ch];
+        std::copy(data + shift, data + numSamples, data);
+        std::copy(tailChannels[ch] + (latency - shift), tailChannels[ch] + latency,
+                  data + numSamples - shift);
+    }
 }
 
 AutoMixer::MixParameters AutoMixer::analyzeTracks(const std::vector<AudioBuffer>& tracks) {
-    MixParameters params;
+    // One pass per track finds the dead air metering and analysis can skip
+    trackSilence_.clear();
+    for (const auto& track : tracks) {
+        trackSilence_.emplace_back(track);
+    }
+    return analyzeIndexedTracks(tracks);
+}
+
+AutoMixer::MixParameters AutoMixer::analyzeIndexedTracks(const std::vector<AudioBuffer>& tracks) {
+    MixParameters params = makeDefaultParameters(settings_, tracks.size());
     
     // Calculate optimal levels
     params.trackGains = calculateOptimalLevels(tracks);
     
-    // Initialize EQ settings
-    params.trackEQs.resize(tracks.size());
-    
     // Resolve frequency conflicts
     if (settings_.enableDynamicEQ) {
         resolveFrequencyConflicts(tracks, params.trackEQs);
     }
     
-    // Calculate pan positions
-    if (settings_.enableSpatialProcessing) {
-        params.panPositions = calculatePanPositions(tracks);
-    } else {
-        params.panPositions.resize(tracks.size(), 0.0f);
+    return params;
+}
+
+AutoMixer::MixParameters AutoMixer::makeDefaultParameters(const AutoMixerSettings& settings,
+                                                          size_t numTracks) {
+    MixParameters params;
+    params.trackGains.assign(numTracks, 1.0f);
+    params.trackEQs.resize(numTracks);
+    params.panPositions.assign(numTracks, 0.0f);
+    
+    // Simple pan distribution, -0.8 to +0.8
+    if (settings.enableSpatialProcessing && numTracks > 1) {
+        float panRange = 0.8f;
+        float step = (2.0f * panRange) / (numTracks - 1);
+        
+        for (size_t i = 0; i < numTracks; ++i) {
+            params.panPositions[i] = -panRange + (i * step);
+        }
     }
     
     // Set mix bus compressor
-    params.mixBusCompressor.threshold = settings_.mixBusCompThreshold;
-    params.mixBusCompressor.ratio = settings_.mixBusCompRatio;
+    params.mixBusCompressor.threshold = settings.mixBusCompThreshold;
+    params.mixBusCompressor.ratio = settings.mixBusCompRatio;
     params.mixBusCompressor.attack = 10.0f;
     params.mixBusCompressor.release = 100.0f;
     
+    // Ducker: fast in so speech onsets are clear, slow out to avoid pumping
+    params.duckingCompressor.threshold = settings.duckingThreshold;
+    params.duckingCompressor.ratio = settings.duckingRatio;
+    params.duckingCompressor.attack = 5.0f;
+    params.duckingCompressor.release = 250.0f;
+    params.duckingCompressor.knee = 6.0f;
+    
     return params;
 }
 
@@ -91,7 +420,7 @@ std::vector<float> AutoMixer::calculateOptimalLevels(const std::vector<AudioBuff
     
     // Measure LUFS for each track
     for (size_t i = 0; i < tracks.size(); ++i) {
-        lufsValues[i] = measureLUFS(tracks[i]);
+        lufsValues[i] = measureLUFS(tracks[i], trackSilence_[i]);
     }
     
     // Calculate average LUFS
@@ -112,54 +441,139 @@ std::vector<float> AutoMixer::calculateOptimalLevels(const std::vector<AudioBuff
 
 void AutoMixer::resolveFrequencyConflicts(const std::vector<AudioBuffer>& tracks,
                                          std::vector<std::vector<EQBand>>& eqSettings) {
-    // Simplified frequency conflict resolution
-    // In a real implementation, this would analyze spectral content
-    // and create complementary EQ curves
+    // Each track's spectrum is analyzed once; candidate EQ moves are then
+    // scored on predicted spectra instead of re-filtering the audio.
+    static const float kCandidateFrequencies[] = {
+        63.0f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f
+    };
+    
+    const size_t numBins = analyzer_->getFFTSize() / 2 + 1;
+    std::vector<float> binFrequencies(numBins);
+    for (size_t b = 0; b < numBins; ++b) {
+        binFrequencies[b] = analyzer_->getBinFrequency(b, settings_.sampleRate);
+    }
     
+    std::vector<std::vector<float>> spectra(tracks.size());
+    std::vector<float> totalPower(numBins, 0.0f);
     for (size_t i = 0; i < tracks.size(); ++i) {
-        // Example: Create basic frequency slots
-        EQBand band;
-        band.frequency = 1000.0f * (i + 1);
-        band.gain = 2.0f;
-        band.q = 0.7f;
-        eqSettings[i].push_back(band);
+        spectra[i] = analyzeTrackSpectrum(tracks[i], trackSilence_[i]);
+        for (size_t b = 0; b < numBins; ++b) {
+            totalPower[b] += spectra[i][b] * spectra[i][b];
+        }
+    }
+    
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        // Cost: energy shared with the rest of the mix, plus any energy
+        // removed where this track is the dominant source
+        auto cost = [&](const std::vector<float>& predicted) {
+            float total = 0.0f;
+            for (size_t b = 0; b < numBins; ++b) {
+                float own = spectra[i][b] * spectra[i][b];
+                float others = std::max(totalPower[b] - own, 0.0f);
+                float power = predicted[b] * predicted[b];
+                total += std::min(power, others);
+                if (own > others) {
+                    total += own - power;
+                }
+            }
+            return total;
+        };
+        
+        float bestCost = cost(spectra[i]);
+        EQBand bestBand;
+        bool found = false;
+        
+        for (float frequency : kCandidateFrequencies) {
+            if (frequency >= 0.5f * settings_.sampleRate) {
+                break;
+            }
+            for (float depth : {0.5f, 1.0f}) {
+                EQBand band;
+                band.frequency = frequency;
+                band.gain = -depth * settings_.frequencySeparation;
+                band.q = 1.0f;
+                
+                float candidateCost = cost(predictSpectrum(spectra[i], binFrequencies, {band}));
+                if (candidateCost < bestCost) {
+                    bestCost = candidateCost;
+                    bestBand = band;
+                    found = true;
+                }
+            }
+        }
+        
+        if (found) {
+            eqSettings[i].push_back(bestBand);
+        }
     }
 }
 
-std::vector<float> AutoMixer::calculatePanPositions(const std::vector<AudioBuffer>& tracks) {
-    std::vector<float> positions(tracks.size());
+std::vector<float> AutoMixer::analyzeTrackSpectrum(const AudioBuffer& track,
+                                                   const SilenceIndex& silence) {
+    std::vector<float> magnitude(analyzer_->getFFTSize() / 2 + 1, 0.0f);
+    const size_t numChannels = track.getNumChannels();
     
-    // Simple pan distribution
-    if (tracks.size() == 1) {
-        positions[0] = 0.0f; // Center
-    } else {
-        float panRange = 0.8f; // -0.8 to +0.8
-        float step = (2.0f * panRange) / (tracks.size() - 1);
-        
-        for (size_t i = 0; i < tracks.size(); ++i) {
-            positions[i] = -panRange + (i * step);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        std::vector<float> channelMagnitude =
+            analyzer_->analyze(track.getChannelData(ch), track.getNumSamples(), &silence);
+        for (size_t b = 0; b < magnitude.size(); ++b) {
+            magnitude[b] += channelMagnitude[b] / numChannels;
         }
     }
     
-    return positions;
+    return magnitude;
 }
 
-float AutoMixer::measureLUFS(const AudioBuffer& buffer) {
+std::vector<float> AutoMixer::predictSpectrum(const std::vector<float>& magnitude,
+                                              const std::vector<float>& binFrequencies,
+                                              const std::vector<EQBand>& bands) {
+    std::vector<BiquadCoeffs> coeffs(bands.size());
+    for (size_t b = 0; b < bands.size(); ++b) {
+        coeffs[b] = Equalizer::calculateCoeffs(bands[b], settings_.sampleRate);
+    }
+    
+    std::vector<float> predicted(magnitude.size());
+    computeCascadeMagnitude(coeffs.data(), coeffs.size(), settings_.sampleRate,
+                            binFrequencies.data(), predicted.data(), predicted.size());
+    for (size_t b = 0; b < predicted.size(); ++b) {
+        predicted[b] *= magnitude[b];
+    }
+    
+    return predicted;
+}
+
+float AutoMixer::measureLUFS(const AudioBuffer& buffer, const SilenceIndex& silence) {
     // Simplified LUFS measurement
     // Real implementation would follow ITU-R BS.1770 standard
     
-    float sum = 0.0f;
-    size_t totalSamples = 0;
-    
+    // Silent blocks add at most threshold^2 per sample; only active regions
+    // are summed, 8 lanes at a time
+    __m256 sum = _mm256_setzero_ps();
+    float tailSum = 0.0f;
     for (size_t ch = 0; ch < buffer.getNumChannels(); ++ch) {
         const float* data = buffer.getChannelData(ch);
-        for (size_t i = 0; i < buffer.getNumSamples(); ++i) {
-            sum += data[i] * data[i];
-            totalSamples++;
-        }
+        silence.forEachActiveRegion([&](size_t start, size_t length) {
+            size_t i = start;
+            const size_t end = start + length;
+            for (; i + 8 <= end; i += 8) {
+                __m256 x = _mm256_loadu_ps(&data[i]);
+                sum = _mm256_fmadd_ps(x, x, sum);
+            }
+            for (; i < end; ++i) {
+                tailSum += data[i] * data[i];
+            }
+        });
+    }
+    
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, sum);
+    float total = tailSum;
+    for (float lane : lanes) {
+        total += lane;
     }
     
-    float meanSquare = sum / totalSamples;
+    const size_t totalSamples = buffer.getNumChannels() * buffer.getNumSamples();
+    float meanSquare = total / totalSamples;
     float lufs = -0.691f + 10.0f * std::log10(meanSquare + 1e-10f);
     
     return lufs;
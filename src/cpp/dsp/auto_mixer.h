@@ -1,15 +1,19 @@
 #pragma once
 
 #include "core/audio_buffer.h"
+#include "core/silence_index.h"
 #include "dsp/spectrum_analyzer.h"
 #include "effects/compressor.h"
 #include "effects/equalizer.h"
+#include "effects/gate.h"
+#include "effects/limiter.h"
 #include <vector>
 #include <memory>
 
 namespace audio_practice {
 
 struct AutoMixerSettings {
+    float sampleRate = 48000.0f;        // Sample rate of all tracks
     float targetLUFS = -16.0f;          // Target loudness
     float maxGainReduction = 12.0f;    // Maximum gain reduction in dB
     float frequencySeparation = 3.0f;   // Minimum frequency separation in dB
@@ -17,6 +21,14 @@ struct AutoMixerSettings {
     bool enableSpatialProcessing = true; // Enable auto-panning
     float mixBusCompRatio = 2.0f;      // Mix bus compression ratio
     float mixBusCompThreshold = -6.0f; // Mix bus compression threshold
+    float mixBusCeiling = -1.0f;       // Mix bus limiter ceiling in dBFS
+    std::vector<size_t> voiceTracks;   // Indices of dialogue/vocal tracks
+    bool enableDucking = true;         // Duck the other tracks under voice tracks
+    float duckingThreshold = -30.0f;   // Voice level where ducking starts (dB)
+    float duckingRatio = 3.0f;         // Ducking compression ratio
+    float duckingLookahead = 10.0f;    // ms the duck leads the voice
+    bool enableGate = false;           // Gate bleed and noise on every track
+    float gateThreshold = -50.0f;      // Track gate threshold in dB, before the track gain
 };
 
 class AutoMixer {
@@ -28,6 +40,13 @@ public:
 
     // Process multiple tracks and return mixed result
     AudioBuffer process(const std::vector<AudioBuffer>& tracks);
+    
+    // Mix independent sessions in parallel, one result per session in order.
+    // Each worker reuses its own mixer for the sessions it picks up, so short
+    // jobs do not pay for setup. numThreads = 0 uses the shared pool.
+    static std::vector<AudioBuffer> processBatch(
+        const std::vector<std::vector<AudioBuffer>>& sessions,
+        const AutoMixerSettings& settings, size_t numThreads = 0);
 
     // Analyze tracks and compute optimal mixing parameters
     struct MixParameters {
@@ -35,39 +54,86 @@ public:
         std::vector<std::vector<EQBand>> trackEQs;
         std::vector<float> panPositions;
         CompressorSettings mixBusCompressor;
+        CompressorSettings duckingCompressor;
     };
 
     MixParameters analyzeTracks(const std::vector<AudioBuffer>& tracks);
+    
+    // Parameters that need no analysis: unity gains, no EQ, tracks spread
+    // across the stereo field (when enabled) and the bus dynamics settings
+    static MixParameters makeDefaultParameters(const AutoMixerSettings& settings,
+                                               size_t numTracks);
+    
+    // Left/right gains for a track at pan (-1..1). Mono tracks are panned
+    // with constant power, stereo tracks balanced.
+    static void computePanGains(float pan, size_t numChannels, float gains[2]);
 
 private:
     AutoMixerSettings settings_;
     std::unique_ptr<SpectrumAnalyzer> analyzer_;
     std::unique_ptr<Compressor> mixBusCompressor_;
+    std::unique_ptr<Compressor> duckingCompressor_;
+    std::unique_ptr<Limiter> mixBusLimiter_;
     std::vector<std::unique_ptr<Equalizer>> trackEQs_;
+    std::vector<std::unique_ptr<Gate>> trackGates_;
+    std::vector<SilenceIndex> trackSilence_;  // per input track, built by analyzeTracks or gateTrack
 
     void initializeProcessors();
     
+    bool isVoiceTrack(size_t index) const;
+    
+    // Duck musicBus under voiceBus, which is lookahead samples longer; the
+    // sidechain is read that far ahead of the audio it controls
+    void duckUnderVoice(AudioBuffer& musicBus, const AudioBuffer& voiceBus,
+                        const CompressorSettings& settings, size_t lookahead);
+    
+    // Brickwall limit the mix bus, compensating the limiter latency
+    void limitMixBus(AudioBuffer& mixBus);
+    
+    // analyzeTracks with trackSilence_ already built for these tracks
+    MixParameters analyzeIndexedTracks(const std::vector<AudioBuffer>& tracks);
+    
     // Level balancing using LUFS measurement
     std::vector<float> calculateOptimalLevels(
         const std::vector<AudioBuffer>& tracks);
     
-    // Frequency conflict resolution
+    // Frequency conflict resolution: at most one cut per track (never a
+    // boost), chosen on predicted post-EQ spectra to reduce the energy the
+    // track shares with the rest of the mix where it is not the dominant source
     void resolveFrequencyConflicts(
         const std::vector<AudioBuffer>& tracks,
         std::vector<std::vector<EQBand>>& eqSettings);
     
-    // Automatic spatial positioning
-    std::vector<float> calculatePanPositions(
-        const std::vector<AudioBuffer>& tracks);
+    // Channel-averaged magnitude spectrum of a track
+    std::vector<float> analyzeTrackSpectrum(const AudioBuffer& track, const SilenceIndex& silence);
+    
+    // Post-EQ magnitude spectrum predicted from a cached spectrum,
+    // without rendering audio
+    std::vector<float> predictSpectrum(const std::vector<float>& magnitude,
+                                       const std::vector<float>& binFrequencies,
+                                       const std::vector<EQBand>& bands);
+    
+    // Gate one track in place and build its trackSilence_ entry. Blocks the
+    // gate holds fully closed are zeroed and marked silent.
+    void gateTrack(size_t index, AudioBuffer& track);
+    
+    // Apply gain and EQ to one track in place. skipBlocks gets one entry
+    // per Gate::kHintBlockSize samples, set where the track is silent (dead
+    // air or gated) after processing and need not be mixed.
+    void processTrack(size_t index,
+                      AudioBuffer& track,
+                      float gain,
+                      const std::vector<EQBand>& eqBands,
+                      std::vector<uint8_t>& skipBlocks);
     
-    // Apply processing to individual track
-    void processTrack(AudioBuffer& track, 
-                     float gain,
-                     const std::vector<EQBand>& eqBands,
-                     float pan);
+    // Pan a track into a stereo bus per computePanGains, skipping silent blocks
+    void mixTrack(AudioBuffer& bus,
+                  const AudioBuffer& track,
+                  float pan,
+                  const std::vector<uint8_t>& skipBlocks);
     
-    // LUFS measurement
-    float measureLUFS(const AudioBuffer& buffer);
+    // LUFS measurement; silent blocks are skipped
+    float measureLUFS(const AudioBuffer& buffer, const SilenceIndex& silence);
     
     // Spectral centroid for pan positioning
     float calculateSpectralCentroid(const AudioBuffer& buffer);
@@ -0,0 +1,169 @@
+#include "dsp/biquad.h"
+#include "dsp/simd_math.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <vector>
+
+namespace audio_practice {
+
+namespace {
+
+using CascadeKernel = void (*)(const BiquadCoeffs*, BiquadState*, float*, size_t);
+
+// Indexed by section count
+const CascadeKernel kCascadeKernels[kMaxFusedBiquads + 1] = {
+    nullptr,
+    &processBiquadCascade<1>,
+    &processBiquadCascade<2>,
+    &processBiquadCascade<3>,
+    &processBiquadCascade<4>,
+    &processBiquadCascade<5>,
+    &processBiquadCascade<6>,
+    &processBiquadCascade<7>,
+    &processBiquadCascade<8>,
+    &processBiquadCascade<9>,
+    &processBiquadCascade<10>,
+    &processBiquadCascade<11>,
+    &processBiquadCascade<12>,
+};
+
+} // namespace
+
+void processBiquadCascade(const BiquadCoeffs* coeffs, BiquadState* states,
+                          size_t numSections, float* data, size_t numSamples) {
+    // Cascades longer than the largest kernel make one pass per chunk
+    while (numSections > 0) {
+        size_t chunk = std::min(numSections, kMaxFusedBiquads);
+        kCascadeKernels[chunk](coeffs, states, data, numSamples);
+        coeffs += chunk;
+        states += chunk;
+        numSections -= chunk;
+    }
+}
+
+BiquadBlockCoeffs makeBiquadBlockCoeffs(const BiquadCoeffs& coeffs) {
+    BiquadBlockCoeffs block;
+    block.coeffs = coeffs;
+
+    // Run the recursion in double precision from three basis conditions:
+    // unit impulse with zero state, and zero input with unit s1 / unit s2
+    auto response = [&coeffs](double x0, double s1, double s2, float* out) {
+        for (size_t k = 0; k < kBiquadBlockSize; ++k) {
+            double x = (k == 0) ? x0 : 0.0;
+            double y = coeffs.a0 * x + s1;
+            s1 = coeffs.a1 * x - coeffs.b1 * y + s2;
+            s2 = coeffs.a2 * x - coeffs.b2 * y;
+            out[k] = static_cast<float>(y);
+        }
+    };
+
+    float h[kBiquadBlockSize];
+    response(1.0, 0.0, 0.0, h);
+    response(0.0, 1.0, 0.0, block.fromS1);
+    response(0.0, 0.0, 1.0, block.fromS2);
+
+    for (size_t j = 0; j < kBiquadBlockSize; ++j) {
+        for (size_t k = 0; k < kBiquadBlockSize; ++k) {
+            block.impulse[j][k] = (k >= j) ? h[k - j] : 0.0f;
+        }
+    }
+
+    return block;
+}
+
+void processBiquadCascadeBlockParallel(const BiquadBlockCoeffs* coeffs, BiquadState* states,
+                                       size_t numSections, float* data, size_t numSamples) {
+    alignas(32) float x[kBiquadBlockSize];
+    alignas(32) float y[kBiquadBlockSize];
+
+    size_t i = 0;
+    for (; i + kBiquadBlockSize <= numSamples; i += kBiquadBlockSize) {
+        _mm256_store_ps(x, _mm256_loadu_ps(&data[i]));
+
+        for (size_t k = 0; k < numSections; ++k) {
+            const BiquadBlockCoeffs& bc = coeffs[k];
+            BiquadState& state = states[k];
+
+            // Contribution of the incoming state
+            __m256 out = _mm256_mul_ps(_mm256_set1_ps(state.s1), _mm256_load_ps(bc.fromS1));
+            out = _mm256_fmadd_ps(_mm256_set1_ps(state.s2), _mm256_load_ps(bc.fromS2), out);
+
+            // Zero-state response, one broadcast input per column
+            for (size_t j = 0; j < kBiquadBlockSize; ++j) {
+                out = _mm256_fmadd_ps(_mm256_broadcast_ss(&x[j]),
+                                      _mm256_load_ps(bc.impulse[j]), out);
+            }
+            _mm256_store_ps(y, out);
+
+            // State after the block only depends on the last two samples
+            const BiquadCoeffs& c = bc.coeffs;
+            const float s2Prev = c.a2 * x[6] - c.b2 * y[6];
+            state.s1 = c.a1 * x[7] - c.b1 * y[7] + s2Prev;
+            state.s2 = c.a2 * x[7] - c.b2 * y[7];
+
+            std::copy(y, y + kBiquadBlockSize, x);
+        }
+
+        _mm256_storeu_ps(&data[i], _mm256_load_ps(x));
+    }
+
+    // Remaining samples use the serial recursion
+    for (; i < numSamples; ++i) {
+        float v = data[i];
+        for (size_t k = 0; k < numSections; ++k) {
+            v = processBiquadSample(coeffs[k].coeffs, states[k].s1, states[k].s2, v);
+        }
+        data[i] = v;
+    }
+}
+
+void computeCascadeMagnitude(const BiquadCoeffs* coeffs, size_t numSections, float sampleRate,
+                             const float* frequencies, float* magnitudes, size_t count) {
+    // With phi = 4 sin^2(w/2), each section's power response is
+    //   |H|^2 = (n0 - n1 phi + n2 phi^2) / (d0 - d1 phi + d2 phi^2)
+    // which keeps precision where the response is deep (e.g. pass filter stopbands)
+    struct PowerTerms {
+        float n0, n1, n2, d0, d1, d2;
+    };
+    std::vector<PowerTerms> terms(numSections);
+    for (size_t k = 0; k < numSections; ++k) {
+        const BiquadCoeffs& c = coeffs[k];
+        const float sumB = c.a0 + c.a1 + c.a2;
+        const float sumA = 1.0f + c.b1 + c.b2;
+        terms[k] = {sumB * sumB,
+                    c.a0 * c.a1 + 4.0f * c.a0 * c.a2 + c.a1 * c.a2,
+                    c.a0 * c.a2,
+                    sumA * sumA,
+                    c.b1 + 4.0f * c.b2 + c.b1 * c.b2,
+                    c.b2};
+    }
+    
+    const __m256 halfOmegaScale = _mm256_set1_ps(static_cast<float>(M_PI) / sampleRate);
+    alignas(32) float freq[8];
+    alignas(32) float mag[8];
+    
+    for (size_t i = 0; i < count; i += 8) {
+        const size_t n = std::min<size_t>(8, count - i);
+        std::fill(freq, freq + 8, 0.0f);
+        std::copy(frequencies + i, frequencies + i + n, freq);
+        
+        __m256 sinHalf, cosHalf;
+        simd::sincos_ps(_mm256_mul_ps(_mm256_load_ps(freq), halfOmegaScale), sinHalf, cosHalf);
+        __m256 phi = _mm256_mul_ps(_mm256_set1_ps(4.0f), _mm256_mul_ps(sinHalf, sinHalf));
+        
+        __m256 power = _mm256_set1_ps(1.0f);
+        for (const PowerTerms& t : terms) {
+            __m256 num = _mm256_fmsub_ps(_mm256_set1_ps(t.n2), phi, _mm256_set1_ps(t.n1));
+            num = _mm256_fmadd_ps(num, phi, _mm256_set1_ps(t.n0));
+            __m256 den = _mm256_fmsub_ps(_mm256_set1_ps(t.d2), phi, _mm256_set1_ps(t.d1));
+            den = _mm256_fmadd_ps(den, phi, _mm256_set1_ps(t.d0));
+            power = _mm256_mul_ps(power, _mm256_div_ps(_mm256_max_ps(num, _mm256_setzero_ps()), den));
+        }
+        
+        _mm256_store_ps(mag, _mm256_sqrt_ps(power));
+        std::copy(mag, mag + n, magnitudes + i);
+    }
+}
+
+} // namespace audio_practice
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+
+namespace audio_practice {
+
+// Normalized biquad coefficients.
+// a0..a2 are the feed-forward taps, b1/b2 the feedback taps (denominator a0 == 1).
+struct BiquadCoeffs {
+    float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
+    float b1 = 0.0f, b2 = 0.0f;
+};
+
+// Transposed direct form II state
+struct BiquadState {
+    float s1 = 0.0f, s2 = 0.0f;
+};
+
+// Largest cascade with a dedicated fused kernel; longer cascades run in chunks
+constexpr size_t kMaxFusedBiquads = 12;
+
+// Single transposed direct form II step
+inline float processBiquadSample(const BiquadCoeffs& c, float& s1, float& s2, float input) {
+    float output = c.a0 * input + s1;
+    s1 = c.a1 * input - c.b1 * output + s2;
+    s2 = c.a2 * input - c.b2 * output;
+    return output;
+}
+
+// Run NumSections cascaded biquads per sample in a single pass over the data.
+// Coefficients and state are copied into locals so the compiler can keep the
+// whole cascade in registers; band count costs compute, not memory bandwidth.
+template <size_t NumSections>
+void processBiquadCascade(const BiquadCoeffs* coeffs, BiquadState* states,
+                          float* data, size_t numSamples) {
+    BiquadCoeffs c[NumSections];
+    float s1[NumSections];
+    float s2[NumSections];
+
+    for (size_t k = 0; k < NumSections; ++k) {
+        c[k] = coeffs[k];
+        s1[k] = states[k].s1;
+        s2[k] = states[k].s2;
+    }
+
+    for (size_t i = 0; i < numSamples; ++i) {
+        float x = data[i];
+        for (size_t k = 0; k < NumSections; ++k) {
+            x = processBiquadSample(c[k], s1[k], s2[k], x);
+        }
+        data[i] = x;
+    }
+
+    for (size_t k = 0; k < NumSections; ++k) {
+        states[k].s1 = s1[k];
+        states[k].s2 = s2[k];
+    }
+}
+
+// Dispatch to the fused kernel matching numSections
+void processBiquadCascade(const BiquadCoeffs* coeffs, BiquadState* states,
+                          size_t numSections, float* data, size_t numSamples);
+
+// Outputs evaluated per step by the block-parallel kernel (one AVX register)
+constexpr size_t kBiquadBlockSize = 8;
+
+// State-space form of a biquad over a block of kBiquadBlockSize samples:
+//   y[k] = sum_j impulse[j][k] * x[j] + fromS1[k] * s1 + fromS2[k] * s2
+// impulse[j] is the zero-state response to x[j] (h[k - j], zero for k < j), so
+// all outputs of a block come from independent FMAs instead of a serial chain.
+struct BiquadBlockCoeffs {
+    alignas(32) float impulse[kBiquadBlockSize][kBiquadBlockSize];
+    alignas(32) float fromS1[kBiquadBlockSize];
+    alignas(32) float fromS2[kBiquadBlockSize];
+    BiquadCoeffs coeffs;  // for the end-of-block state update and tails
+};
+
+BiquadBlockCoeffs makeBiquadBlockCoeffs(const BiquadCoeffs& coeffs);
+
+// Block-parallel cascade for a single long channel: each section evaluates
+// kBiquadBlockSize outputs per step. Matches processBiquadCascade up to
+// float rounding.
+void processBiquadCascadeBlockParallel(const BiquadBlockCoeffs* coeffs, BiquadState* states,
+                                       size_t numSections, float* data, size_t numSamples);
+
+// Linear magnitude response |H(f)| of a cascade at arbitrary frequencies (Hz),
+// evaluated 8 frequencies per step
+void computeCascadeMagnitude(const BiquadCoeffs* coeffs, size_t numSections, float sampleRate,
+                             const float* frequencies, float* magnitudes, size_t count);
+
+} // namespace audio_practice
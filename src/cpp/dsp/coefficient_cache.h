@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace audio_practice {
+
+// Process-wide cache of computed filter coefficients, so thousands of
+// processors running identical presets share the setup work.
+// Lookups take a shared lock; inserts take an exclusive one.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class CoefficientCache {
+public:
+    explicit CoefficientCache(size_t capacity = 4096) : capacity_(capacity) {}
+
+    bool find(const Key& key, Value& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    void insert(const Key& key, const Value& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        // Presets are few in practice; start over rather than track recency
+        if (entries_.size() >= capacity_) {
+            entries_.clear();
+        }
+        entries_[key] = value;
+    }
+
+    void clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    size_t capacity_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<Key, Value, Hash> entries_;
+};
+
+} // namespace audio_practice
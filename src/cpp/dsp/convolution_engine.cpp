@@ -0,0 +1,305 @@
+#include "dsp/convolution_engine.h"
+#include <algorithm>
+#include <immintrin.h>
+#include <stdexcept>
+
+namespace audio_practice {
+
+namespace {
+
+bool isPowerOfTwo(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+size_t roundUp(size_t n, size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+UniformConvolver::UniformConvolver(size_t partitionSize, const float* ir, size_t irLength)
+    : partitionSize_(partitionSize),
+      numPartitions_(std::max<size_t>(1, (irLength + partitionSize - 1) / partitionSize)),
+      binStride_(roundUp(partitionSize + 1, 8)),
+      fft_(2 * partitionSize) {
+    irRe_.assign(numPartitions_ * binStride_, 0.0f);
+    irIm_.assign(numPartitions_ * binStride_, 0.0f);
+    fdlRe_.assign(numPartitions_ * binStride_, 0.0f);
+    fdlIm_.assign(numPartitions_ * binStride_, 0.0f);
+    frame_.assign(2 * partitionSize_, 0.0f);
+    accRe_.assign(binStride_, 0.0f);
+    accIm_.assign(binStride_, 0.0f);
+    timeBuffer_.assign(2 * partitionSize_, 0.0f);
+
+    // Partition spectra: B taps zero-padded to the 2B transform
+    for (size_t p = 0; p < numPartitions_; ++p) {
+        std::fill(timeBuffer_.begin(), timeBuffer_.end(), 0.0f);
+        const size_t start = p * partitionSize_;
+        const size_t count = std::min(partitionSize_, irLength - std::min(irLength, start));
+        std::copy(ir + start, ir + start + count, timeBuffer_.begin());
+        fft_.forward(timeBuffer_.data(), &irRe_[p * binStride_], &irIm_[p * binStride_]);
+    }
+}
+
+void UniformConvolver::reset() {
+    std::fill(fdlRe_.begin(), fdlRe_.end(), 0.0f);
+    std::fill(fdlIm_.begin(), fdlIm_.end(), 0.0f);
+    std::fill(frame_.begin(), frame_.end(), 0.0f);
+    fdlPos_ = 0;
+}
+
+void UniformConvolver::processBlock(const float* input, float* output) {
+    const size_t B = partitionSize_;
+
+    // Overlap-save frame: previous block followed by the new one
+    std::copy(frame_.begin() + B, frame_.end(), frame_.begin());
+    std::copy(input, input + B, frame_.begin() + B);
+
+    // Newest spectrum goes one slot back in the delay line ring
+    fdlPos_ = (fdlPos_ + numPartitions_ - 1) % numPartitions_;
+    fft_.forward(frame_.data(), &fdlRe_[fdlPos_ * binStride_], &fdlIm_[fdlPos_ * binStride_]);
+
+    // acc = sum_p X[n - p] * H[p], complex multiply-accumulate 8 bins at a time
+    std::fill(accRe_.begin(), accRe_.end(), 0.0f);
+    std::fill(accIm_.begin(), accIm_.end(), 0.0f);
+    for (size_t p = 0; p < numPartitions_; ++p) {
+        const size_t slot = (fdlPos_ + p) % numPartitions_;
+        const float* xr = &fdlRe_[slot * binStride_];
+        const float* xi = &fdlIm_[slot * binStride_];
+        const float* hr = &irRe_[p * binStride_];
+        const float* hi = &irIm_[p * binStride_];
+
+        for (size_t k = 0; k < binStride_; k += 8) {
+            __m256 vxr = _mm256_loadu_ps(xr + k);
+            __m256 vxi = _mm256_loadu_ps(xi + k);
+            __m256 vhr = _mm256_loadu_ps(hr + k);
+            __m256 vhi = _mm256_loadu_ps(hi + k);
+            __m256 re = _mm256_loadu_ps(&accRe_[k]);
+            __m256 im = _mm256_loadu_ps(&accIm_[k]);
+            re = _mm256_fmadd_ps(vxr, vhr, re);
+            re = _mm256_fnmadd_ps(vxi, vhi, re);
+            im = _mm256_fmadd_ps(vxr, vhi, im);
+            im = _mm256_fmadd_ps(vxi, vhr, im);
+            _mm256_storeu_ps(&accRe_[k], re);
+            _mm256_storeu_ps(&accIm_[k], im);
+        }
+    }
+
+    // The second half of the circular result is the linear convolution
+    fft_.inverse(accRe_.data(), accIm_.data(), timeBuffer_.data());
+    std::copy(timeBuffer_.begin() + B, timeBuffer_.end(), output);
+}
+
+std::vector<PartitionStage> ConvolutionEngine::planStages(size_t irLength, size_t headSize,
+                                                          size_t maxPartitionSize, bool deferredTail) {
+    std::vector<PartitionStage> stages;
+    size_t offset = 0;
+    size_t size = headSize;
+
+    while (offset < irLength) {
+        const size_t nextSize = std::min(size * 4, maxPartitionSize);
+        size_t end = irLength;
+
+        if (nextSize > size) {
+            // A stage of size B finishes a block B samples after it starts
+            // collecting it, so it may only cover IR samples from B - latency
+            // onwards (2B - latency if it runs one block behind)
+            const size_t due = deferredTail ? 2 * nextSize : nextSize;
+            const size_t nextOffset = std::max(offset + size, due > headSize ? due - headSize : 0);
+            end = std::min(irLength, offset + roundUp(nextOffset - offset, size));
+        }
+
+        stages.push_back({size, offset, end - offset});
+        offset = end;
+        size = nextSize;
+    }
+
+    return stages;
+}
+
+ConvolutionEngine::ConvolutionEngine(const float* ir, size_t irLength,
+                                     size_t headSize, size_t maxPartitionSize,
+                                     bool asyncTail)
+    : headSize_(headSize), asyncTail_(asyncTail) {
+    if (!isPowerOfTwo(headSize) || !isPowerOfTwo(maxPartitionSize) || maxPartitionSize < headSize) {
+        throw std::invalid_argument("Partition sizes must be powers of two with max >= head");
+    }
+
+    stages_ = planStages(irLength, headSize, maxPartitionSize, asyncTail_);
+
+    size_t largest = headSize;
+    size_t lastOffset = 0;
+    stageData_.resize(stages_.size());
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        const PartitionStage& stage = stages_[k];
+        stageData_[k].convolver = std::make_unique<UniformConvolver>(
+            stage.partitionSize, ir + stage.offset, stage.length);
+        stageData_[k].input.assign(stage.partitionSize, 0.0f);
+        stageData_[k].output.assign(stage.partitionSize, 0.0f);
+        largest = std::max(largest, stage.partitionSize);
+        lastOffset = std::max(lastOffset, stage.offset);
+    }
+
+    history_.assign(nextPowerOfTwo(largest), 0.0f);
+    historyMask_ = history_.size() - 1;
+    accum_.assign(nextPowerOfTwo(headSize + lastOffset + largest), 0.0f);
+    accumMask_ = accum_.size() - 1;
+
+    inBlock_.assign(headSize, 0.0f);
+    outBlock_.assign(headSize, 0.0f);
+
+    tailJobs_ = std::make_unique<std::atomic<int>[]>(stages_.size());
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        tailJobs_[k].store(kIdle, std::memory_order_relaxed);
+    }
+    if (asyncTail_ && stages_.size() > 1) {
+        tailWorker_ = std::thread([this] { tailLoop(); });
+    }
+}
+
+ConvolutionEngine::~ConvolutionEngine() {
+    if (tailWorker_.joinable()) {
+        stopping_.store(true, std::memory_order_release);
+        tailSignal_.post();
+        tailWorker_.join();
+    }
+}
+
+void ConvolutionEngine::tailLoop() {
+    for (;;) {
+        tailSignal_.wait();
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+        // Smaller stages are due sooner, so serve them first
+        for (size_t k = 1; k < stages_.size(); ++k) {
+            runTailJob(k);
+        }
+    }
+}
+
+bool ConvolutionEngine::runTailJob(size_t k) {
+    int expected = kQueued;
+    if (!tailJobs_[k].compare_exchange_strong(expected, kRunning, std::memory_order_acquire)) {
+        return false;
+    }
+    Stage& stage = stageData_[k];
+    stage.convolver->processBlock(stage.input.data(), stage.output.data());
+    tailJobs_[k].store(kDone, std::memory_order_release);
+    return true;
+}
+
+bool ConvolutionEngine::collectTailJob(size_t k) {
+    if (tailJobs_[k].load(std::memory_order_acquire) == kIdle) {
+        return false;
+    }
+    // Still queued: the worker is late, so compute it here. Already running:
+    // it finishes within one block's compute time.
+    if (runTailJob(k)) {
+        ++lateTailBlocks_;
+    }
+    while (tailJobs_[k].load(std::memory_order_acquire) != kDone) {
+        std::this_thread::yield();
+    }
+    tailJobs_[k].store(kIdle, std::memory_order_relaxed);
+    return true;
+}
+
+void ConvolutionEngine::waitForTail() {
+    for (size_t k = 1; k < stages_.size(); ++k) {
+        collectTailJob(k);
+    }
+}
+
+void ConvolutionEngine::reset() {
+    waitForTail();
+    for (auto& stage : stageData_) {
+        stage.convolver->reset();
+    }
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    std::fill(accum_.begin(), accum_.end(), 0.0f);
+    std::fill(outBlock_.begin(), outBlock_.end(), 0.0f);
+    time_ = 0;
+    blockFill_ = 0;
+}
+
+void ConvolutionEngine::process(const float* input, float* output, size_t numSamples) {
+    while (numSamples > 0) {
+        const size_t n = std::min(numSamples, headSize_ - blockFill_);
+        std::copy(input, input + n, inBlock_.begin() + blockFill_);
+        std::copy(outBlock_.begin() + blockFill_, outBlock_.begin() + blockFill_ + n, output);
+
+        blockFill_ += n;
+        input += n;
+        output += n;
+        numSamples -= n;
+
+        if (blockFill_ == headSize_) {
+            tick();
+            blockFill_ = 0;
+        }
+    }
+}
+
+void ConvolutionEngine::accumulate(const Stage& stage, size_t base) {
+    for (size_t j = 0; j < stage.output.size(); ++j) {
+        accum_[(base + j) & accumMask_] += stage.output[j];
+    }
+}
+
+void ConvolutionEngine::tick() {
+    for (size_t j = 0; j < headSize_; ++j) {
+        history_[(time_ + j) & historyMask_] = inBlock_[j];
+    }
+    time_ += headSize_;
+
+    // Every stage whose block just completed adds its output into the ring
+    // at the IR offset it covers, shifted by the engine latency
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        const size_t B = stages_[k].partitionSize;
+        if (time_ % B != 0) {
+            continue;
+        }
+
+        Stage& stage = stageData_[k];
+        const size_t start = time_ - B;
+        const size_t base = start + headSize_ + stages_[k].offset;
+        const bool deferred = asyncTail_ && k > 0;
+
+        // A deferred block is collected one period after hand-off; planning
+        // guarantees its output is not due before then
+        if (deferred && collectTailJob(k)) {
+            accumulate(stage, stage.pendingBase);
+        }
+
+        for (size_t j = 0; j < B; ++j) {
+            stage.input[j] = history_[(start + j) & historyMask_];
+        }
+
+        if (deferred) {
+            stage.pendingBase = base;
+            tailJobs_[k].store(kQueued, std::memory_order_release);
+            tailSignal_.post();
+        } else {
+            stage.convolver->processBlock(stage.input.data(), stage.output.data());
+            accumulate(stage, base);
+        }
+    }
+
+    // Hand out the next block and clear it for reuse
+    for (size_t j = 0; j < headSize_; ++j) {
+        float& slot = accum_[(time_ + j) & accumMask_];
+        outBlock_[j] = slot;
+        slot = 0.0f;
+    }
+}
+
+} // namespace audio_practice
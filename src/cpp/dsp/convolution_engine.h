@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/semaphore.h"
+#include "dsp/fft.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace audio_practice {
+
+// Uniformly partitioned overlap-save convolution of one impulse response
+// segment. The segment is split into partitions of B samples whose spectra
+// (FFT size 2B) are multiply-accumulated against a frequency-domain delay
+// line of past input spectra with AVX2.
+class UniformConvolver {
+public:
+    UniformConvolver(size_t partitionSize, const float* ir, size_t irLength);
+
+    // Convolve exactly getPartitionSize() new input samples. output[j] is the
+    // full convolution at the time of input[j].
+    void processBlock(const float* input, float* output);
+
+    void reset();
+
+    size_t getPartitionSize() const { return partitionSize_; }
+    size_t getNumPartitions() const { return numPartitions_; }
+
+private:
+    size_t partitionSize_;
+    size_t numPartitions_;
+    size_t binStride_;  // bins rounded up to the SIMD width
+    RealFFT fft_;
+
+    std::vector<float> irRe_, irIm_;    // numPartitions_ x binStride_
+    std::vector<float> fdlRe_, fdlIm_;  // ring of input spectra, same shape
+    size_t fdlPos_ = 0;
+
+    std::vector<float> frame_;  // previous block followed by the new block
+    std::vector<float> accRe_, accIm_;
+    std::vector<float> timeBuffer_;
+};
+
+// One uniformly partitioned piece of a non-uniform partitioning
+struct PartitionStage {
+    size_t partitionSize;
+    size_t offset;  // first IR sample covered
+    size_t length;  // IR samples covered
+};
+
+// Convolution with a non-uniform partitioning: a small head partition for
+// low latency and progressively larger partitions for the rest of the IR, so
+// cost per sample grows only slowly with IR length. Accepts any block size.
+//
+// With asyncTail, every stage after the head is computed on a worker thread
+// owned by the engine: a stage's block is posted to a preallocated job slot
+// when it completes and collected one block period later, so the calling
+// thread only runs the head and cheap bookkeeping. Posting never allocates
+// or locks. If the worker has not started a block by the time it is due
+// (e.g. it was starved of CPU), the calling thread claims the job and
+// computes it inline instead of waiting; it only waits for a block the
+// worker is already computing. Output is identical either way.
+class ConvolutionEngine {
+public:
+    ConvolutionEngine(const float* ir, size_t irLength,
+                      size_t headSize = 128, size_t maxPartitionSize = 4096,
+                      bool asyncTail = false);
+    ~ConvolutionEngine();
+
+    ConvolutionEngine(const ConvolutionEngine&) = delete;
+    ConvolutionEngine& operator=(const ConvolutionEngine&) = delete;
+
+    // Output is the convolution delayed by getLatency() samples
+    void process(const float* input, float* output, size_t numSamples);
+
+    void reset();
+
+    size_t getLatency() const { return headSize_; }
+    const std::vector<PartitionStage>& getStages() const { return stages_; }
+    
+    // Deferred tail blocks the calling thread had to compute itself because
+    // the worker had not started them in time
+    size_t getLateTailBlocks() const { return lateTailBlocks_; }
+
+    // Split an IR into stages growing by 4x up to maxPartitionSize. Each stage
+    // starts late enough that its blocks finish before their output is due;
+    // with deferredTail, stages after the head get one extra block period so
+    // they can be computed asynchronously.
+    static std::vector<PartitionStage> planStages(size_t irLength, size_t headSize,
+                                                  size_t maxPartitionSize, bool deferredTail = false);
+
+private:
+    struct Stage {
+        std::unique_ptr<UniformConvolver> convolver;
+        std::vector<float> input;
+        std::vector<float> output;
+        size_t pendingBase = 0;  // output ring position of the deferred block
+    };
+
+    // Deferred block of one stage: Idle -> Queued -> Running -> Done -> Idle.
+    // Whoever moves Queued to Running (worker or calling thread) computes it.
+    enum TailJob : int { kIdle, kQueued, kRunning, kDone };
+
+    size_t headSize_;
+    bool asyncTail_;
+    std::vector<PartitionStage> stages_;
+    std::vector<Stage> stageData_;
+    std::unique_ptr<std::atomic<int>[]> tailJobs_;  // one per stage
+    Semaphore tailSignal_;
+    std::atomic<bool> stopping_{false};
+    std::thread tailWorker_;
+    size_t lateTailBlocks_ = 0;
+
+    std::vector<float> history_;  // input ring, power-of-two size
+    size_t historyMask_;
+    std::vector<float> accum_;    // output accumulation ring, power-of-two size
+    size_t accumMask_;
+    size_t time_ = 0;             // input samples consumed at the last tick
+
+    std::vector<float> inBlock_;
+    std::vector<float> outBlock_;
+    size_t blockFill_ = 0;
+
+    void tick();
+    void accumulate(const Stage& stage, size_t base);
+    bool runTailJob(size_t k);
+    bool collectTailJob(size_t k);
+    void waitForTail();
+    void tailLoop();
+};
+
+} // namespace audio_practice
@@ -0,0 +1,123 @@
+#include "dsp/envelope_detector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace audio_practice {
+
+namespace {
+
+float timeCoeff(float ms, float sampleRate) {
+    return std::exp(-1.0f / (ms * sampleRate / 1000.0f));
+}
+
+// One-pole follower step. Both candidate updates are computed and the right
+// one picked with min/max: with the faster coefficient smaller, the attack
+// update is the larger of the two exactly when the input is above the
+// envelope. This keeps the serial dependency to one FMA and one max.
+template <bool AttackFaster>
+inline float follow(float envelope, float level, float attackCoeff, float attackInput,
+                    float releaseCoeff, float releaseInput) {
+    float attacked = std::fma(attackCoeff, envelope, attackInput * level);
+    float released = std::fma(releaseCoeff, envelope, releaseInput * level);
+    return AttackFaster ? std::max(attacked, released) : std::min(attacked, released);
+}
+
+template <bool AttackFaster>
+float followBlock(const float* levels, float* envelopes, size_t numSamples, float envelope,
+                  float attackCoeff, float releaseCoeff) {
+    const float attackInput = 1.0f - attackCoeff;
+    const float releaseInput = 1.0f - releaseCoeff;
+    for (size_t i = 0; i < numSamples; ++i) {
+        envelope = follow<AttackFaster>(envelope, std::abs(levels[i]), attackCoeff, attackInput,
+                                        releaseCoeff, releaseInput);
+        envelopes[i] = envelope;
+    }
+    return envelope;
+}
+
+} // namespace
+
+EnvelopeDetector::EnvelopeDetector(const EnvelopeDetectorSettings& settings)
+    : settings_(settings) {
+    updateCoefficients();
+    squares_.setWindow(std::max<size_t>(1, static_cast<size_t>(settings_.rmsWindow * sampleRate_ / 1000.0f)));
+}
+
+void EnvelopeDetector::prepare(float sampleRate, size_t maxBlockSize) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    updateCoefficients();
+    squares_.setWindow(std::max<size_t>(1, static_cast<size_t>(settings_.rmsWindow * sampleRate_ / 1000.0f)));
+    reset();
+}
+
+void EnvelopeDetector::setSettings(const EnvelopeDetectorSettings& settings) {
+    settings_ = settings;
+    updateCoefficients();
+    
+    size_t window = std::max<size_t>(1, static_cast<size_t>(settings_.rmsWindow * sampleRate_ / 1000.0f));
+    if (window != squares_.getWindow()) {
+        squares_.setWindow(window);
+    }
+}
+
+void EnvelopeDetector::updateCoefficients() {
+    attackCoeff_ = timeCoeff(settings_.attack, sampleRate_);
+    releaseCoeff_ = timeCoeff(settings_.release, sampleRate_);
+    slowAttackCoeff_ = timeCoeff(settings_.release, sampleRate_);
+    slowReleaseCoeff_ = timeCoeff(settings_.release * 5.0f, sampleRate_);
+}
+
+void EnvelopeDetector::reset() {
+    envelope_ = 0.0f;
+    slowEnvelope_ = 0.0f;
+    squares_.reset();
+}
+
+void EnvelopeDetector::process(const float* input, float* envelope, size_t numSamples) {
+    const bool attackFaster = attackCoeff_ <= releaseCoeff_;
+    
+    switch (settings_.mode) {
+        case DetectorMode::Peak:
+            envelope_ = attackFaster
+                ? followBlock<true>(input, envelope, numSamples, envelope_, attackCoeff_, releaseCoeff_)
+                : followBlock<false>(input, envelope, numSamples, envelope_, attackCoeff_, releaseCoeff_);
+            break;
+            
+        case DetectorMode::Rms: {
+            // Windowed mean square in O(1) per sample, then the same ballistics
+            const double invWindow = 1.0 / static_cast<double>(squares_.getWindow());
+            for (size_t i = 0; i < numSamples; ++i) {
+                double meanSquare = squares_.push(input[i] * input[i]) * invWindow;
+                envelope[i] = static_cast<float>(std::sqrt(std::max(meanSquare, 0.0)));
+            }
+            envelope_ = attackFaster
+                ? followBlock<true>(envelope, envelope, numSamples, envelope_, attackCoeff_, releaseCoeff_)
+                : followBlock<false>(envelope, envelope, numSamples, envelope_, attackCoeff_, releaseCoeff_);
+            break;
+        }
+            
+        case DetectorMode::ProgramDependent: {
+            const float attackInput = 1.0f - attackCoeff_;
+            const float releaseInput = 1.0f - releaseCoeff_;
+            const float slowAttackInput = 1.0f - slowAttackCoeff_;
+            const float slowReleaseInput = 1.0f - slowReleaseCoeff_;
+            float fast = envelope_;
+            float slow = slowEnvelope_;
+            for (size_t i = 0; i < numSamples; ++i) {
+                float level = std::abs(input[i]);
+                fast = attackFaster
+                    ? follow<true>(fast, level, attackCoeff_, attackInput, releaseCoeff_, releaseInput)
+                    : follow<false>(fast, level, attackCoeff_, attackInput, releaseCoeff_, releaseInput);
+                slow = follow<true>(slow, level, slowAttackCoeff_, slowAttackInput,
+                                    slowReleaseCoeff_, slowReleaseInput);
+                envelope[i] = std::max(fast, slow);
+            }
+            envelope_ = fast;
+            slowEnvelope_ = slow;
+            break;
+        }
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
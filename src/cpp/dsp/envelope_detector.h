@@ -0,0 +1,67 @@
+#pragma once
+
+#include "dsp/sliding_window.h"
+#include <cstddef>
+
+namespace audio_practice {
+
+enum class DetectorMode {
+    Peak,              // one-pole attack/release on |x|
+    Rms,               // windowed RMS, then attack/release
+    ProgramDependent   // peak with a release that slows down on sustained material
+};
+
+struct EnvelopeDetectorSettings {
+    DetectorMode mode = DetectorMode::Peak;
+    float attack = 10.0f;     // ms
+    float release = 100.0f;   // ms
+    float rmsWindow = 10.0f;  // ms, Rms mode only
+};
+
+// Level detector shared by the dynamics processors. Writes the envelope
+// (linear amplitude) for a block into a buffer, so one detector can drive
+// several processors that listen to the same signal.
+class EnvelopeDetector {
+public:
+    explicit EnvelopeDetector(const EnvelopeDetectorSettings& settings = {});
+    
+    // Set the sample rate before processing. Recomputes time constants and
+    // clears state.
+    void prepare(float sampleRate, size_t maxBlockSize);
+    float getSampleRate() const { return sampleRate_; }
+    
+    // Only an RMS window length change reallocates
+    void setSettings(const EnvelopeDetectorSettings& settings);
+    const EnvelopeDetectorSettings& getSettings() const { return settings_; }
+    
+    void reset();
+    
+    // Envelope of input into envelope; the two may be the same buffer
+    void process(const float* input, float* envelope, size_t numSamples);
+    
+    // Envelope after the last processed sample
+    float getEnvelope() const { return envelope_; }
+
+private:
+    EnvelopeDetectorSettings settings_;
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    
+    float attackCoeff_;
+    float releaseCoeff_;
+    float envelope_ = 0.0f;
+    
+    // Rms: running sum of squares
+    RunningSum squares_;
+    
+    // ProgramDependent: a slow stage that only charges on sustained material
+    // (attack = release time) and releases 5x slower; the output is the
+    // larger of the two stages
+    float slowAttackCoeff_;
+    float slowReleaseCoeff_;
+    float slowEnvelope_ = 0.0f;
+    
+    void updateCoefficients();
+};
+
+} // namespace audio_practice
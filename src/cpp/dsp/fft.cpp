@@ -0,0 +1,101 @@
+#include "dsp/fft.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace audio_practice {
+
+RealFFT::RealFFT(size_t size)
+    : size_(size), half_(size / 2) {
+    if (size < 4 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("RealFFT size must be a power of two >= 4");
+    }
+
+    twiddles_.resize(half_ / 2);
+    for (size_t k = 0; k < twiddles_.size(); ++k) {
+        twiddles_[k] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * k / half_));
+    }
+
+    realTwiddles_.resize(half_ + 1);
+    for (size_t k = 0; k <= half_; ++k) {
+        realTwiddles_[k] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * k / size_));
+    }
+
+    bitReverse_.resize(half_);
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half_) {
+        ++bits;
+    }
+    for (size_t i = 0; i < half_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse_[i] = r;
+    }
+
+    work_.resize(half_);
+}
+
+void RealFFT::transform(std::complex<float>* data, bool inverse) {
+    for (size_t i = 0; i < half_; ++i) {
+        if (i < bitReverse_[i]) {
+            std::swap(data[i], data[bitReverse_[i]]);
+        }
+    }
+
+    // Iterative radix-2 butterflies
+    for (size_t len = 2; len <= half_; len <<= 1) {
+        const size_t step = half_ / len;
+        for (size_t start = 0; start < half_; start += len) {
+            for (size_t j = 0; j < len / 2; ++j) {
+                std::complex<float> w = twiddles_[j * step];
+                if (inverse) {
+                    w = std::conj(w);
+                }
+                std::complex<float> u = data[start + j];
+                std::complex<float> v = data[start + j + len / 2] * w;
+                data[start + j] = u + v;
+                data[start + j + len / 2] = u - v;
+            }
+        }
+    }
+}
+
+void RealFFT::forward(const float* input, float* re, float* im) {
+    // Pack even/odd samples as real/imaginary parts
+    for (size_t n = 0; n < half_; ++n) {
+        work_[n] = {input[2 * n], input[2 * n + 1]};
+    }
+    transform(work_.data(), false);
+
+    // Split into the spectra of the even and odd samples and recombine
+    for (size_t k = 0; k <= half_; ++k) {
+        std::complex<float> z = work_[k % half_];
+        std::complex<float> zc = std::conj(work_[(half_ - k) % half_]);
+        std::complex<float> even = 0.5f * (z + zc);
+        std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (z - zc);
+        std::complex<float> x = even + realTwiddles_[k] * odd;
+        re[k] = x.real();
+        im[k] = x.imag();
+    }
+}
+
+void RealFFT::inverse(const float* re, const float* im, float* output) {
+    for (size_t k = 0; k < half_; ++k) {
+        std::complex<float> x(re[k], im[k]);
+        std::complex<float> xc(re[half_ - k], -im[half_ - k]);
+        std::complex<float> even = 0.5f * (x + xc);
+        std::complex<float> odd = 0.5f * (x - xc) * std::conj(realTwiddles_[k]);
+        work_[k] = even + std::complex<float>(0.0f, 1.0f) * odd;
+    }
+    transform(work_.data(), true);
+
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (size_t n = 0; n < half_; ++n) {
+        output[2 * n] = work_[n].real() * scale;
+        output[2 * n + 1] = work_[n].imag() * scale;
+    }
+}
+
+} // namespace audio_practice
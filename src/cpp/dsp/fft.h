@@ -0,0 +1,34 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+// Real-input FFT of power-of-two size N, computed as a complex FFT of size
+// N/2. Spectra are N/2 + 1 bins in split real/imaginary arrays, which is the
+// layout the convolution kernels multiply-accumulate with SIMD.
+// forward() is unscaled; inverse() scales by 1/N so inverse(forward(x)) == x.
+class RealFFT {
+public:
+    explicit RealFFT(size_t size);
+
+    void forward(const float* input, float* re, float* im);
+    void inverse(const float* re, const float* im, float* output);
+
+    size_t getSize() const { return size_; }
+    size_t getNumBins() const { return size_ / 2 + 1; }
+
+private:
+    size_t size_;
+    size_t half_;
+    std::vector<std::complex<float>> twiddles_;      // half-size complex FFT
+    std::vector<std::complex<float>> realTwiddles_;  // e^{-2 pi i k / N}
+    std::vector<size_t> bitReverse_;
+    std::vector<std::complex<float>> work_;
+
+    void transform(std::complex<float>* data, bool inverse);
+};
+
+} // namespace audio_practice
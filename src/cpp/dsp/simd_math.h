@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+namespace audio_practice {
+
+// Gains kept in log2 units convert to dB with this factor
+constexpr float kDbPerLog2 = 6.02059991f;  // 20 * log10(2)
+
+namespace simd {
+
+// AVX2 approximations of transcendental functions, 8 lanes at a time.
+// Accuracy is around 1e-7 relative, enough for filter and gain coefficients.
+
+// 2^x, x clamped to [-126, 126]
+inline __m256 exp2_ps(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(126.0f));
+
+    // Split into integer part and fraction in [-0.5, 0.5]
+    __m256 xi = _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 f = _mm256_sub_ps(x, xi);
+
+    // Taylor series of e^(f * ln2)
+    __m256 p = _mm256_set1_ps(1.5403530e-4f);
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.3333558e-3f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(9.6181291e-3f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(5.5504109e-2f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(2.4022651e-1f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(6.9314718e-1f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.0f));
+
+    // Scale by 2^xi through the exponent bits
+    __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(xi), _mm256_set1_epi32(127));
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)));
+}
+
+// log2(x) for positive normal x. The mantissa is reduced to [sqrt(1/2), sqrt(2))
+// with integer ops and log2(m) = 2/ln2 * atanh(s), s = (m - 1) / (m + 1), is
+// summed by its odd series.
+inline __m256 log2_ps(__m256 x) {
+    const __m256i sqrtHalfBits = _mm256_set1_epi32(0x3f3504f3);
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i shifted = _mm256_sub_epi32(bits, sqrtHalfBits);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_srai_epi32(shifted, 23));
+    __m256 m = _mm256_castsi256_ps(_mm256_sub_epi32(
+        bits, _mm256_and_si256(shifted, _mm256_set1_epi32(static_cast<int>(0xff800000)))));
+
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 s = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+    __m256 z = _mm256_mul_ps(s, s);
+    __m256 p = _mm256_set1_ps(1.0f / 9.0f);
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 7.0f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 5.0f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 3.0f));
+    p = _mm256_fmadd_ps(p, z, one);
+    return _mm256_fmadd_ps(_mm256_mul_ps(s, p), _mm256_set1_ps(2.88539008f), e);
+}
+
+// Scalar versions of exp2_ps and log2_ps, same operations in the same order,
+// so scalar and vector code paths produce identical results
+
+inline float exp2_ss(float x) {
+    x = std::min(std::max(x, -126.0f), 126.0f);
+    float xi = std::nearbyint(x);
+    float f = x - xi;
+
+    float p = 1.5403530e-4f;
+    p = std::fma(p, f, 1.3333558e-3f);
+    p = std::fma(p, f, 9.6181291e-3f);
+    p = std::fma(p, f, 5.5504109e-2f);
+    p = std::fma(p, f, 2.4022651e-1f);
+    p = std::fma(p, f, 6.9314718e-1f);
+    p = std::fma(p, f, 1.0f);
+
+    uint32_t scaleBits = static_cast<uint32_t>(static_cast<int32_t>(xi) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+    return p * scale;
+}
+
+inline float log2_ss(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    uint32_t shifted = bits - 0x3f3504f3u;
+    float e = static_cast<float>(static_cast<int32_t>(shifted) >> 23);
+    uint32_t mantissaBits = bits - (shifted & 0xff800000u);
+    float m;
+    std::memcpy(&m, &mantissaBits, sizeof(m));
+
+    float s = (m - 1.0f) / (m + 1.0f);
+    float z = s * s;
+    float p = 1.0f / 9.0f;
+    p = std::fma(p, z, 1.0f / 7.0f);
+    p = std::fma(p, z, 1.0f / 5.0f);
+    p = std::fma(p, z, 1.0f / 3.0f);
+    p = std::fma(p, z, 1.0f);
+    return std::fma(s * p, 2.88539008f, e);
+}
+
+// sin(x) and cos(x) together (Cephes range reduction to [-pi/4, pi/4])
+inline void sincos_ps(__m256 x, __m256& sinOut, __m256& cosOut) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 sinSign = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x);
+
+    // Octant index j, rounded up to even
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(j);
+
+    // Sign flips and polynomial selection per octant
+    __m256 sinSwap = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    __m256 usePolySin = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    sinSign = _mm256_xor_ps(sinSign, sinSwap);
+
+    // Extended precision reduction: x - j * pi/4
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(0.78515625f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(3.77489497744594108e-8f), x);
+    __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 c = _mm256_set1_ps(2.443315711809948e-5f);
+    c = _mm256_fmadd_ps(c, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    c = _mm256_fmadd_ps(c, z, _mm256_set1_ps(4.166664568298827e-2f));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+    c = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, c);
+    c = _mm256_add_ps(c, _mm256_set1_ps(1.0f));
+
+    __m256 s = _mm256_set1_ps(-1.9515295891e-4f);
+    s = _mm256_fmadd_ps(s, z, _mm256_set1_ps(8.3321608736e-3f));
+    s = _mm256_fmadd_ps(s, z, _mm256_set1_ps(-1.6666654611e-1f));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, z), x, x);
+
+    sinOut = _mm256_xor_ps(_mm256_blendv_ps(c, s, usePolySin), sinSign);
+    cosOut = _mm256_xor_ps(_mm256_blendv_ps(s, c, usePolySin), cosSign);
+}
+
+// Transpose an 8x8 tile held as 8 row registers, in place
+inline void transpose8x8_ps(__m256* rows) {
+    __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+} // namespace simd
+} // namespace audio_practice
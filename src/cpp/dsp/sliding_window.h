@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+// Maximum over the last `window` pushed values in O(1) amortized time.
+// Monotonic deque in a fixed ring: values that can no longer be the maximum
+// are dropped on push, so the front is always the window maximum.
+class SlidingMaximum {
+public:
+    explicit SlidingMaximum(size_t window = 1) { setWindow(window); }
+
+    // Allocates; clears the window
+    void setWindow(size_t window) {
+        window_ = window > 0 ? window : 1;
+        values_.assign(window_, 0.0f);
+        times_.assign(window_, 0);
+        reset();
+    }
+    size_t getWindow() const { return window_; }
+
+    void reset() {
+        head_ = 0;
+        count_ = 0;
+        time_ = 0;
+    }
+
+    float push(float value) {
+        // Drop the front once it leaves the window, making room for value
+        if (count_ > 0 && times_[head_] + window_ <= time_) {
+            head_ = index(1);
+            --count_;
+        }
+
+        // Drop queued values that the new one dominates
+        while (count_ > 0 && values_[index(count_ - 1)] <= value) {
+            --count_;
+        }
+        values_[index(count_)] = value;
+        times_[index(count_)] = time_;
+        ++count_;
+
+        ++time_;
+        return values_[head_];
+    }
+
+private:
+    size_t window_ = 1;
+    std::vector<float> values_;
+    std::vector<size_t> times_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t time_ = 0;
+
+    size_t index(size_t offset) const {
+        size_t i = head_ + offset;
+        return i >= window_ ? i - window_ : i;
+    }
+};
+
+// Sum over the last `window` pushed values in O(1) per sample. The sum is
+// kept in double so rounding does not accumulate over long streams.
+class RunningSum {
+public:
+    explicit RunningSum(size_t window = 1) { setWindow(window); }
+
+    // Allocates; clears the window
+    void setWindow(size_t window) {
+        window_ = window > 0 ? window : 1;
+        values_.assign(window_, 0.0f);
+        reset();
+    }
+    size_t getWindow() const { return window_; }
+
+    void reset() {
+        std::fill(values_.begin(), values_.end(), 0.0f);
+        pos_ = 0;
+        sum_ = 0.0;
+    }
+
+    // Returns the sum including value
+    double push(float value) {
+        sum_ += static_cast<double>(value) - values_[pos_];
+        values_[pos_] = value;
+        pos_ = (pos_ + 1 == window_) ? 0 : pos_ + 1;
+        return sum_;
+    }
+
+    double getSum() const { return sum_; }
+
+private:
+    size_t window_ = 1;
+    std::vector<float> values_;
+    size_t pos_ = 0;
+    double sum_ = 0.0;
+};
+
+} // namespace audio_practice
@@ -1,12 +1,15 @@
 #include "dsp/spectrum_analyzer.h"
+#include <algorithm>
 #include <cmath>
 
 namespace audio_practice {
 
 SpectrumAnalyzer::SpectrumAnalyzer(size_t fftSize) 
-    : fftSize_(fftSize) {
+    : fftSize_(fftSize), fft_(fftSize) {
     window_.resize(fftSize);
-    fftBuffer_.resize(fftSize);
+    frame_.resize(fftSize);
+    re_.resize(fft_.getNumBins());
+    im_.resize(fft_.getNumBins());
     generateWindow();
 }
 
@@ -19,12 +22,34 @@ void SpectrumAnalyzer::generateWindow() {
     }
 }
 
-std::vector<float> SpectrumAnalyzer::analyze(const float* data, size_t numSamples) {
+std::vector<float> SpectrumAnalyzer::analyze(const float* data, size_t numSamples,
+                                             const SilenceIndex* silence) {
     std::vector<float> magnitude(fftSize_ / 2 + 1, 0.0f);
     
-    // Simple placeholder - in real implementation would use FFT library
-    for (size_t i = 0; i < magnitude.size(); ++i) {
-        magnitude[i] = 0.1f; // Placeholder
+    // Short inputs are zero-padded into a single frame
+    const size_t hop = fftSize_ / 2;
+    const size_t numFrames = numSamples > fftSize_ ? (numSamples - fftSize_) / hop + 1 : 1;
+    
+    float windowSum = 0.0f;
+    for (float w : window_) {
+        windowSum += w;
+    }
+    const float scale = 2.0f / (windowSum * numFrames);
+    
+    for (size_t f = 0; f < numFrames; ++f) {
+        const float* frameData = data + f * hop;
+        const size_t available = std::min(fftSize_, numSamples - f * hop);
+        if (silence && silence->isSilent(f * hop, available)) {
+            continue;
+        }
+        for (size_t i = 0; i < fftSize_; ++i) {
+            frame_[i] = i < available ? frameData[i] * window_[i] : 0.0f;
+        }
+        
+        fft_.forward(frame_.data(), re_.data(), im_.data());
+        for (size_t k = 0; k < magnitude.size(); ++k) {
+            magnitude[k] += std::sqrt(re_[k] * re_[k] + im_[k] * im_[k]) * scale;
+        }
     }
     
     return magnitude;
@@ -38,8 +63,4 @@ float SpectrumAnalyzer::getBinFrequency(size_t bin, float sampleRate) const {
     return bin * sampleRate / fftSize_;
 }
 
-void SpectrumAnalyzer::performFFT(std::vector<std::complex<float>>& data) {
-    // Placeholder - would use FFT library
-}
-
 } // namespace audio_practice 
\ No newline at end of file
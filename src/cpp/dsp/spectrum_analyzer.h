@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/silence_index.h"
+#include "dsp/fft.h"
 #include <vector>
 #include <complex>
 #include <memory>
@@ -12,7 +14,11 @@ public:
     ~SpectrumAnalyzer();
 
     // Analyze audio buffer and return magnitude spectrum
-    std::vector<float> analyze(const float* data, size_t numSamples);
+    // (Hann-windowed frames with 50% overlap, averaged; sine amplitude scale).
+    // With a silence index of the data, frames lying entirely in silent
+    // blocks are not transformed and count as zero.
+    std::vector<float> analyze(const float* data, size_t numSamples,
+                               const SilenceIndex* silence = nullptr);
     
     // Get frequency bin for a given frequency
     size_t getFrequencyBin(float frequency, float sampleRate) const;
@@ -25,10 +31,12 @@ public:
 private:
     size_t fftSize_;
     std::vector<float> window_;
-    std::vector<std::complex<float>> fftBuffer_;
+    std::vector<float> frame_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    RealFFT fft_;
     
     void generateWindow();
-    void performFFT(std::vector<std::complex<float>>& data);
 };
 
-} // namespace audio_practice 
\ No newline at end of file
+} // namespace audio_practice 
@@ -0,0 +1,271 @@
+#include "dsp/streaming_mixer.h"
+#include "core/denormals.h"
+#include "core/silence_index.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace audio_practice {
+
+namespace {
+
+// Time constant of the running loudness estimate, in seconds
+constexpr float kLoudnessWindow = 3.0f;
+
+// Blocks quieter than this (mean square) leave the loudness estimate alone
+constexpr float kSilentMeanSquare =
+    SilenceIndex::kDefaultThreshold * SilenceIndex::kDefaultThreshold;
+
+// data[i] *= gain moving linearly from `from` towards `to` across the block
+void applyGainRamp(float* data, size_t numSamples, float from, float to) {
+    const float step = (to - from) / static_cast<float>(numSamples);
+    __m256 gain = _mm256_add_ps(_mm256_set1_ps(from),
+                                _mm256_mul_ps(_mm256_set1_ps(step),
+                                              _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)));
+    const __m256 gainStep = _mm256_set1_ps(8.0f * step);
+    
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(&data[i], _mm256_mul_ps(_mm256_loadu_ps(&data[i]), gain));
+        gain = _mm256_add_ps(gain, gainStep);
+    }
+    for (; i < numSamples; ++i) {
+        data[i] *= from + step * static_cast<float>(i);
+    }
+}
+
+// dst += src * gain
+void accumulate(float* dst, const float* src, float gain, size_t numSamples) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 sum = _mm256_fmadd_ps(_mm256_loadu_ps(&src[i]), g, _mm256_loadu_ps(&dst[i]));
+        _mm256_storeu_ps(&dst[i], sum);
+    }
+    for (; i < numSamples; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+float meanSquare(const float* const* channels, size_t numChannels, size_t numSamples) {
+    __m256 sum = _mm256_setzero_ps();
+    float tailSum = 0.0f;
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        const float* data = channels[ch];
+        size_t i = 0;
+        for (; i + 8 <= numSamples; i += 8) {
+            __m256 x = _mm256_loadu_ps(&data[i]);
+            sum = _mm256_fmadd_ps(x, x, sum);
+        }
+        for (; i < numSamples; ++i) {
+            tailSum += data[i] * data[i];
+        }
+    }
+    
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, sum);
+    float total = tailSum;
+    for (float lane : lanes) {
+        total += lane;
+    }
+    return total / static_cast<float>(numChannels * numSamples);
+}
+
+} // namespace
+
+void StreamingMixer::Delay::process(float* const* channels, size_t numSamples) {
+    if (length == 0) {
+        return;
+    }
+    for (size_t ch = 0; ch < 2; ++ch) {
+        float* line = &ring[ch * length];
+        float* data = channels[ch];
+        size_t p = pos;
+        for (size_t i = 0; i < numSamples; ++i) {
+            std::swap(line[p], data[i]);
+            p = (p + 1 == length) ? 0 : p + 1;
+        }
+    }
+    pos = (pos + numSamples) % length;
+}
+
+StreamingMixer::StreamingMixer(const AutoMixerSettings& settings,
+                               const std::vector<size_t>& trackChannels, size_t maxBlockSize)
+    : settings_(settings),
+      maxBlockSize_(std::max<size_t>(maxBlockSize, 1)),
+      voiceBus_(2, maxBlockSize_) {
+    GateSettings gateSettings;
+    gateSettings.threshold = settings_.gateThreshold;
+    
+    tracks_.resize(trackChannels.size());
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        Track& track = tracks_[t];
+        track.numChannels = trackChannels[t];
+        track.scratch = AudioBuffer(track.numChannels, maxBlockSize_);
+        track.channels.resize(track.numChannels);
+        for (size_t ch = 0; ch < track.numChannels; ++ch) {
+            track.channels[ch] = track.scratch.getChannelData(ch);
+        }
+        track.gate.setSettings(gateSettings);
+        track.gate.prepare(settings_.sampleRate, maxBlockSize_);
+        track.eq.prepare(settings_.sampleRate, maxBlockSize_, track.numChannels);
+        track.voice = std::find(settings_.voiceTracks.begin(), settings_.voiceTracks.end(), t) !=
+                      settings_.voiceTracks.end();
+        ducking_ = ducking_ || (track.voice && settings_.enableDucking);
+    }
+    
+    // The music bus is delayed so the ducker sees the voice lookahead early
+    lookahead_ = ducking_
+        ? static_cast<size_t>(settings_.duckingLookahead * settings_.sampleRate / 1000.0f) : 0;
+    for (Delay* delay : {&musicDelay_, &voiceDelay_}) {
+        delay->length = lookahead_;
+        delay->ring.assign(2 * lookahead_, 0.0f);
+    }
+    
+    busCompressor_.prepare(settings_.sampleRate, maxBlockSize_);
+    busCompressor_.setLinkMode(Compressor::LinkMode::Max);
+    duckingCompressor_.prepare(settings_.sampleRate, maxBlockSize_);
+    duckingCompressor_.setLinkMode(Compressor::LinkMode::Max);
+    
+    LimiterSettings limiterSettings;
+    limiterSettings.ceiling = settings_.mixBusCeiling;
+    limiter_.setSettings(limiterSettings);
+    limiter_.prepare(settings_.sampleRate, maxBlockSize_, 2);
+    
+    applyParameters(AutoMixer::makeDefaultParameters(settings_, tracks_.size()));
+}
+
+void StreamingMixer::setMixParameters(const AutoMixer::MixParameters& params) {
+    fixedParameters_ = true;
+    applyParameters(params);
+}
+
+void StreamingMixer::applyParameters(const AutoMixer::MixParameters& params) {
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        Track& track = tracks_[t];
+        track.fixedGain = t < params.trackGains.size() ? params.trackGains[t] : 1.0f;
+        track.pan = t < params.panPositions.size() ? params.panPositions[t] : 0.0f;
+        if (!started_) {
+            track.gain = track.fixedGain;
+        }
+        
+        static const std::vector<EQBand> kNoBands;
+        const std::vector<EQBand>& bands = t < params.trackEQs.size() ? params.trackEQs[t] : kNoBands;
+        track.hasEQ = settings_.enableDynamicEQ && !bands.empty();
+        
+        // Same band count ramps to the new settings; coefficients come from
+        // the shared cache here rather than on the audio thread
+        track.eq.setBands(bands);
+    }
+    
+    busCompressor_.setSettings(params.mixBusCompressor);
+    duckingCompressor_.setSettings(params.duckingCompressor);
+}
+
+void StreamingMixer::reset() {
+    for (Track& track : tracks_) {
+        track.gate.reset();
+        track.eq.reset();
+        track.gain = fixedParameters_ ? track.fixedGain : 1.0f;
+        track.meanSquare = 0.0f;
+        track.measured = false;
+    }
+    for (Delay* delay : {&musicDelay_, &voiceDelay_}) {
+        std::fill(delay->ring.begin(), delay->ring.end(), 0.0f);
+        delay->pos = 0;
+    }
+    busCompressor_.reset();
+    duckingCompressor_.reset();
+    limiter_.reset();
+    started_ = false;
+}
+
+void StreamingMixer::process(const float* const* const* tracks, float* const* output,
+                             size_t numSamples) {
+    ScopedNoDenormals noDenormals;
+    started_ = true;
+    
+    for (size_t offset = 0; offset < numSamples; offset += maxBlockSize_) {
+        float* const block[2] = {output[0] + offset, output[1] + offset};
+        processBlock(tracks, block, offset, std::min(maxBlockSize_, numSamples - offset));
+    }
+}
+
+void StreamingMixer::processBlock(const float* const* const* tracks, float* const* output,
+                                  size_t offset, size_t numSamples) {
+    float* const voice[2] = {voiceBus_.getChannelData(0), voiceBus_.getChannelData(1)};
+    for (size_t ch = 0; ch < 2; ++ch) {
+        std::fill(output[ch], output[ch] + numSamples, 0.0f);
+        std::fill(voice[ch], voice[ch] + numSamples, 0.0f);
+    }
+    
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        Track& track = tracks_[t];
+        if (track.numChannels == 0) {
+            continue;
+        }
+        for (size_t ch = 0; ch < track.numChannels; ++ch) {
+            std::copy(tracks[t][ch] + offset, tracks[t][ch] + offset + numSamples,
+                      track.channels[ch]);
+        }
+        
+        // Gain ramps over the block so estimate updates do not click
+        const float gain = fixedParameters_ ? track.fixedGain : updateGain(track, numSamples);
+        for (float* data : track.channels) {
+            applyGainRamp(data, numSamples, track.gain, gain);
+        }
+        track.gain = gain;
+        
+        if (settings_.enableGate) {
+            track.gate.process(track.channels.data(), track.numChannels, numSamples);
+        }
+        if (track.hasEQ) {
+            track.eq.process(track.channels.data(), track.numChannels, numSamples);
+        }
+        
+        float panGains[2];
+        AutoMixer::computePanGains(settings_.enableSpatialProcessing ? track.pan : 0.0f,
+                                   track.numChannels, panGains);
+        float* const* bus = ducking_ && track.voice ? voice : output;
+        for (size_t out = 0; out < 2; ++out) {
+            const float* src = track.channels[track.numChannels == 1 ? 0 : out];
+            accumulate(bus[out], src, panGains[out], numSamples);
+        }
+    }
+    
+    // The ducker reads the voice lookahead samples ahead of the delayed music
+    if (ducking_) {
+        musicDelay_.process(output, numSamples);
+        const float* const sidechain[2] = {voice[0], voice[1]};
+        duckingCompressor_.process(sidechain, 2, output, 2, numSamples);
+        voiceDelay_.process(voice, numSamples);
+        for (size_t ch = 0; ch < 2; ++ch) {
+            accumulate(output[ch], voice[ch], 1.0f, numSamples);
+        }
+    }
+    
+    busCompressor_.process(output, 2, numSamples);
+    limiter_.process(output, 2, numSamples);
+}
+
+float StreamingMixer::updateGain(Track& track, size_t numSamples) {
+    const float level = meanSquare(track.channels.data(), track.numChannels, numSamples);
+    if (level > kSilentMeanSquare) {
+        const float coeff = std::exp(-static_cast<float>(numSamples) /
+                                     (kLoudnessWindow * settings_.sampleRate));
+        track.meanSquare = track.measured ? coeff * track.meanSquare + (1.0f - coeff) * level
+                                          : level;
+        track.measured = true;
+    }
+    if (!track.measured) {
+        return track.gain;
+    }
+    
+    // Same meter as AutoMixer, over active audio only
+    const float lufs = -0.691f + 10.0f * std::log10(track.meanSquare + 1e-10f);
+    const float gainDb = std::clamp(settings_.targetLUFS - lufs,
+                                    -settings_.maxGainReduction, settings_.maxGainReduction);
+    return std::pow(10.0f, gainDb / 20.0f);
+}
+
+} // namespace audio_practice 
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/audio_buffer.h"
+#include "dsp/auto_mixer.h"
+#include "effects/compressor.h"
+#include "effects/equalizer.h"
+#include "effects/gate.h"
+#include "effects/limiter.h"
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+// Block-by-block counterpart of AutoMixer for sessions too long to hold in
+// memory. Every track delivers one aligned block per call and the stereo mix
+// is written to a caller buffer. All state and scratch is allocated up
+// front, so process() does not allocate.
+//
+// Whole-track analysis is not possible while streaming. Mix parameters can
+// be supplied, e.g. from AutoMixer::analyzeTracks on a preview; otherwise
+// each track's gain follows a running loudness estimate towards targetLUFS,
+// limited to +/- maxGainReduction, and tracks are spread across the stereo
+// field. Output lags input by getLatency() samples (ducking lookahead plus
+// the limiter).
+class StreamingMixer {
+public:
+    StreamingMixer(const AutoMixerSettings& settings, const std::vector<size_t>& trackChannels,
+                   size_t maxBlockSize);
+    
+    // Fixed gains, EQ and pans instead of the running estimates
+    void setMixParameters(const AutoMixer::MixParameters& params);
+    
+    // tracks[t] points to getTrackChannels(t) channels and output to 2, all
+    // numSamples long. Longer blocks than maxBlockSize are mixed in pieces.
+    void process(const float* const* const* tracks, float* const* output, size_t numSamples);
+    
+    // Clear all processor state and loudness estimates
+    void reset();
+    
+    size_t getNumTracks() const { return tracks_.size(); }
+    size_t getTrackChannels(size_t track) const { return tracks_[track].numChannels; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    size_t getLatency() const { return lookahead_ + limiter_.getLatency(); }
+    
+    // Linear gain applied to a track at the end of the last block
+    float getTrackGain(size_t track) const { return tracks_[track].gain; }
+
+private:
+    struct Track {
+        size_t numChannels = 0;
+        AudioBuffer scratch{0, 0};        // numChannels x maxBlockSize
+        std::vector<float*> channels;     // into scratch
+        Gate gate;
+        Equalizer eq;
+        bool hasEQ = false;
+        bool voice = false;
+        float pan = 0.0f;
+        float gain = 1.0f;
+        float fixedGain = 1.0f;
+        float meanSquare = 0.0f;          // running loudness estimate
+        bool measured = false;
+    };
+    
+    // Fixed delay for the ducking lookahead
+    struct Delay {
+        std::vector<float> ring;  // 2 channels x length
+        size_t length = 0;
+        size_t pos = 0;
+        
+        void process(float* const* channels, size_t numSamples);
+    };
+    
+    AutoMixerSettings settings_;
+    size_t maxBlockSize_;
+    bool fixedParameters_ = false;
+    bool started_ = false;  // audio processed since construction or reset
+    std::vector<Track> tracks_;
+    
+    AudioBuffer voiceBus_;
+    bool ducking_ = false;
+    size_t lookahead_ = 0;
+    Delay musicDelay_;
+    Delay voiceDelay_;
+    
+    Compressor busCompressor_;
+    Compressor duckingCompressor_;
+    Limiter limiter_;
+    
+    void applyParameters(const AutoMixer::MixParameters& params);
+    
+    void processBlock(const float* const* const* tracks, float* const* output,
+                      size_t offset, size_t numSamples);
+    
+    // Gain for the next block from the track's running loudness
+    float updateGain(Track& track, size_t numSamples);
+};
+
+} // namespace audio_practice 
\ No newline at end of file
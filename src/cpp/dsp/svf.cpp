@@ -0,0 +1,80 @@
+#include "dsp/svf.h"
+#include <algorithm>
+
+namespace audio_practice {
+
+namespace {
+
+// Sections per pass, so the derived coefficients fit on the stack
+constexpr size_t kMaxSvfChunk = 12;
+
+struct SvfKernelCoeffs {
+    float a1, a2, a3;
+    float m0, m1, m2;
+};
+
+inline SvfKernelCoeffs deriveKernelCoeffs(const SvfCoeffs& c) {
+    SvfKernelCoeffs kc;
+    kc.a1 = 1.0f / (1.0f + c.g * (c.g + c.k));
+    kc.a2 = c.g * kc.a1;
+    kc.a3 = c.g * kc.a2;
+    kc.m0 = c.m0;
+    kc.m1 = c.m1;
+    kc.m2 = c.m2;
+    return kc;
+}
+
+inline float processSvfSample(const SvfKernelCoeffs& c, SvfState& s, float v0) {
+    float v3 = v0 - s.ic2eq;
+    float v1 = c.a1 * s.ic1eq + c.a2 * v3;
+    float v2 = s.ic2eq + c.a2 * s.ic1eq + c.a3 * v3;
+    s.ic1eq = 2.0f * v1 - s.ic1eq;
+    s.ic2eq = 2.0f * v2 - s.ic2eq;
+    return c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+}
+
+} // namespace
+
+void processSvfCascade(const SvfCoeffs* coeffs, SvfState* states,
+                       size_t numSections, float* data, size_t numSamples) {
+    SvfKernelCoeffs kc[kMaxSvfChunk];
+    SvfState st[kMaxSvfChunk];
+    
+    for (size_t first = 0; first < numSections; first += kMaxSvfChunk) {
+        const size_t chunk = std::min(kMaxSvfChunk, numSections - first);
+        for (size_t k = 0; k < chunk; ++k) {
+            kc[k] = deriveKernelCoeffs(coeffs[first + k]);
+            st[k] = states[first + k];
+        }
+        
+        for (size_t i = 0; i < numSamples; ++i) {
+            float x = data[i];
+            for (size_t k = 0; k < chunk; ++k) {
+                x = processSvfSample(kc[k], st[k], x);
+            }
+            data[i] = x;
+        }
+        
+        std::copy(st, st + chunk, states + first);
+    }
+}
+
+void processSvfCascadeRamp(SvfCoeffs* coeffs, const SvfCoeffs* steps, SvfState* states,
+                           size_t numSections, float* data, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        float x = data[i];
+        for (size_t k = 0; k < numSections; ++k) {
+            SvfCoeffs& c = coeffs[k];
+            const SvfCoeffs& step = steps[k];
+            c.g += step.g;
+            c.k += step.k;
+            c.m0 += step.m0;
+            c.m1 += step.m1;
+            c.m2 += step.m2;
+            x = processSvfSample(deriveKernelCoeffs(c), states[k], x);
+        }
+        data[i] = x;
+    }
+}
+
+} // namespace audio_practice
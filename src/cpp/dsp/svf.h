@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace audio_practice {
+
+// Topology-preserving (trapezoidal) state-variable filter after Zavalishin
+// and Simper. The output mixes input, band and low outputs,
+//   y = m0 * x + m1 * band + m2 * low,
+// which covers peak, shelf and pass responses with one structure. Updating
+// coefficients needs a single tan(), and the filter stays stable when g and
+// k change every sample, so parameters can be modulated without a reset.
+struct SvfCoeffs {
+    float g = 0.0f;   // tan(pi * fc / fs)
+    float k = 1.0f;   // damping, 1/Q
+    float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+};
+
+struct SvfState {
+    float ic1eq = 0.0f, ic2eq = 0.0f;
+};
+
+// Run a cascade of SVFs per sample in a single pass over the data
+void processSvfCascade(const SvfCoeffs* coeffs, SvfState* states,
+                       size_t numSections, float* data, size_t numSamples);
+
+// Same, with every coefficient moving by `steps` each sample. coeffs is
+// advanced in place and holds the final values on return.
+void processSvfCascadeRamp(SvfCoeffs* coeffs, const SvfCoeffs* steps, SvfState* states,
+                           size_t numSections, float* data, size_t numSamples);
+
+} // namespace audio_practice
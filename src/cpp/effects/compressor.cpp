@@ -1,11 +1,23 @@
 #include "effects/compressor.h"
+#include "dsp/simd_math.h"
 #include <cmath>
 #include <algorithm>
 
 namespace audio_practice {
 
+namespace {
+
+constexpr float kLog2PerDb = 1.0f / kDbPerLog2;
+
+// Detector buffer length until prepare() says otherwise
+constexpr size_t kDefaultBlockSize = 512;
+
+} // namespace
+
 Compressor::Compressor(const CompressorSettings& settings)
-    : settings_(settings), envelope_(0.0f), currentGainReduction_(0.0f) {
+    : settings_(settings), currentGainReduction_(0.0f) {
+    gains_.resize(kDefaultBlockSize);
+    link_.resize(kDefaultBlockSize);
     updateCoefficients();
 }
 
@@ -14,56 +26,187 @@ void Compressor::setSettings(const CompressorSettings& settings) {
     updateCoefficients();
 }
 
-void Compressor::updateCoefficients(float sampleRate) {
+void Compressor::prepare(float sampleRate, size_t maxBlockSize) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    gains_.assign(maxBlockSize > 0 ? maxBlockSize : kDefaultBlockSize, 0.0f);
+    link_.assign(gains_.size(), 0.0f);
+    detector_.prepare(sampleRate, gains_.size());
+    updateCoefficients();
+    reset();
+}
+
+void Compressor::reset() {
+    detector_.reset();
+    currentGainReduction_ = 0.0f;
+}
+
+CompressorCurve makeCompressorCurve(const CompressorSettings& settings, float sampleRate) {
+    CompressorCurve c;
+    
     // Convert ms to samples
-    float attackSamples = settings_.attack * sampleRate / 1000.0f;
-    float releaseSamples = settings_.release * sampleRate / 1000.0f;
+    float attackSamples = settings.attack * sampleRate / 1000.0f;
+    float releaseSamples = settings.release * sampleRate / 1000.0f;
     
     // Calculate coefficients
-    attackCoeff_ = std::exp(-1.0f / attackSamples);
-    releaseCoeff_ = std::exp(-1.0f / releaseSamples);
+    c.attackCoeff = std::exp(-1.0f / attackSamples);
+    c.releaseCoeff = std::exp(-1.0f / releaseSamples);
+    
+    // Gain curve parameters, converted once so the per-sample path needs
+    // only one log2 and one exp2
+    c.threshold = settings.threshold * kLog2PerDb;
+    c.kneeStart = (settings.threshold - settings.knee / 2.0f) * kLog2PerDb;
+    // A hard knee becomes a very steep one
+    c.invKnee = settings.knee > 0.0f ? 1.0f / (settings.knee * kLog2PerDb) : 1e30f;
+    c.slope = 1.0f - 1.0f / settings.ratio;
+    c.makeup = settings.makeupGain * kLog2PerDb;
+    
+    return c;
 }
 
-float Compressor::computeGain(float inputLevel) {
-    float inputDb = 20.0f * std::log10(std::max(inputLevel, 1e-10f));
+void Compressor::updateCoefficients() {
+    curve_ = makeCompressorCurve(settings_, sampleRate_);
+    detector_.setSettings({settings_.detector, settings_.attack, settings_.release, settings_.rmsWindow});
+}
+
+void Compressor::detect(const float* input, size_t numSamples) {
+    detector_.process(input, gains_.data(), numSamples);
+}
+
+float Compressor::computeGains(size_t numSamples) {
+    float* gains = gains_.data();
+    float gainLog2 = 0.0f;
     
-    // Soft knee compression
-    float kneeStart = settings_.threshold - settings_.knee / 2.0f;
-    float kneeEnd = settings_.threshold + settings_.knee / 2.0f;
+    const __m256 threshold = _mm256_set1_ps(curve_.threshold);
+    const __m256 kneeStart = _mm256_set1_ps(curve_.kneeStart);
+    const __m256 invKnee = _mm256_set1_ps(curve_.invKnee);
+    const __m256 slope = _mm256_set1_ps(curve_.slope);
+    const __m256 makeup = _mm256_set1_ps(curve_.makeup);
     
-    float gainReduction = 0.0f;
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 gain = compressorGainLog2(_mm256_loadu_ps(&gains[i]),
+                                         threshold, kneeStart, invKnee, slope, makeup);
+        _mm256_storeu_ps(&gains[i], simd::exp2_ps(gain));
+        gainLog2 = _mm256_cvtss_f32(_mm256_permutevar8x32_ps(gain, _mm256_set1_epi32(7)));
+    }
     
-    if (inputDb > kneeEnd) {
-        // Above knee - full compression
-        float excess = inputDb - settings_.threshold;
-        gainReduction = excess * (1.0f - 1.0f / settings_.ratio);
-    } else if (inputDb > kneeStart) {
-        // In knee region - smooth transition
-        float kneeProgress = (inputDb - kneeStart) / settings_.knee;
-        float excess = inputDb - settings_.threshold;
-        gainReduction = excess * (1.0f - 1.0f / settings_.ratio) * kneeProgress * kneeProgress;
+    // Scalar tail, bit-identical to the vector lanes
+    for (; i < numSamples; ++i) {
+        gainLog2 = compressorGainLog2(gains[i], curve_);
+        gains[i] = simd::exp2_ss(gainLog2);
     }
     
-    return std::pow(10.0f, (-gainReduction + settings_.makeupGain) / 20.0f);
+    return gainLog2;
+}
+
+void Compressor::applyGains(float* data, size_t numSamples) const {
+    const float* gains = gains_.data();
+    
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(&data[i], _mm256_mul_ps(_mm256_loadu_ps(&data[i]), _mm256_loadu_ps(&gains[i])));
+    }
+    for (; i < numSamples; ++i) {
+        data[i] *= gains[i];
+    }
 }
 
 void Compressor::process(float* data, size_t numSamples) {
-    for (size_t i = 0; i < numSamples; ++i) {
-        float inputLevel = std::abs(data[i]);
-        
-        // Update envelope
-        if (inputLevel > envelope_) {
-            envelope_ = inputLevel + (envelope_ - inputLevel) * attackCoeff_;
+    process(data, data, numSamples);
+}
+
+void Compressor::process(const float* sidechain, float* data, size_t numSamples) {
+    process(&sidechain, 1, &data, 1, numSamples);
+}
+
+void Compressor::linkChannels(const float* const* channels, size_t numChannels,
+                              size_t offset, size_t numSamples) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const float scale = (linkMode_ == LinkMode::Sum) ? 1.0f / static_cast<float>(numChannels) : 1.0f;
+    float* link = link_.data();
+    
+    std::fill(link, link + numSamples, 0.0f);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        const float* in = channels[ch] + offset;
+        size_t i = 0;
+        if (linkMode_ == LinkMode::Max) {
+            for (; i + 8 <= numSamples; i += 8) {
+                __m256 level = _mm256_and_ps(_mm256_loadu_ps(&in[i]), absMask);
+                _mm256_storeu_ps(&link[i], _mm256_max_ps(_mm256_loadu_ps(&link[i]), level));
+            }
+            for (; i < numSamples; ++i) {
+                link[i] = std::max(link[i], std::abs(in[i]));
+            }
+        } else {
+            const __m256 vscale = _mm256_set1_ps(scale);
+            for (; i + 8 <= numSamples; i += 8) {
+                __m256 level = _mm256_and_ps(_mm256_loadu_ps(&in[i]), absMask);
+                _mm256_storeu_ps(&link[i], _mm256_fmadd_ps(level, vscale, _mm256_loadu_ps(&link[i])));
+            }
+            for (; i < numSamples; ++i) {
+                link[i] = std::fma(std::abs(in[i]), scale, link[i]);
+            }
+        }
+    }
+}
+
+void Compressor::process(float* const* channels, size_t numChannels, size_t numSamples) {
+    process(channels, numChannels, channels, numChannels, numSamples);
+}
+
+void Compressor::process(const float* const* sidechain, size_t numSidechainChannels,
+                         float* const* channels, size_t numChannels, size_t numSamples) {
+    if (numSidechainChannels == 0) {
+        return;
+    }
+    
+    float gainLog2 = 0.0f;
+    
+    // One detector and one gain curve for all channels; only the final
+    // multiply runs per channel. Blocks larger than the detector buffer are
+    // processed in pieces.
+    for (size_t pos = 0; pos < numSamples;) {
+        const size_t n = std::min(numSamples - pos, gains_.size());
+        if (numSidechainChannels == 1) {
+            detect(sidechain[0] + pos, n);
         } else {
-            envelope_ = inputLevel + (envelope_ - inputLevel) * releaseCoeff_;
+            linkChannels(sidechain, numSidechainChannels, pos, n);
+            detect(link_.data(), n);
         }
-        
-        // Compute and apply gain
-        float gain = computeGain(envelope_);
-        data[i] *= gain;
-        
-        // Update gain reduction meter
-        currentGainReduction_ = 20.0f * std::log10(gain);
+        gainLog2 = computeGains(n);
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            applyGains(channels[ch] + pos, n);
+        }
+        pos += n;
+    }
+    
+    // Update gain reduction meter from the last sample of the block
+    if (numSamples > 0) {
+        currentGainReduction_ = gainLog2 * kDbPerLog2;
+    }
+}
+
+void Compressor::applyEnvelope(const float* envelope, float* data, size_t numSamples) {
+    applyEnvelope(envelope, &data, 1, numSamples);
+}
+
+void Compressor::applyEnvelope(const float* envelope, float* const* channels,
+                               size_t numChannels, size_t numSamples) {
+    float gainLog2 = 0.0f;
+    
+    for (size_t pos = 0; pos < numSamples;) {
+        const size_t n = std::min(numSamples - pos, gains_.size());
+        std::copy(envelope + pos, envelope + pos + n, gains_.begin());
+        gainLog2 = computeGains(n);
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            applyGains(channels[ch] + pos, n);
+        }
+        pos += n;
+    }
+    
+    if (numSamples > 0) {
+        currentGainReduction_ = gainLog2 * kDbPerLog2;
     }
 }
 
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "dsp/envelope_detector.h"
+#include "dsp/simd_math.h"
+#include <algorithm>
+#include <cstddef>
+#include <immintrin.h>
+#include <vector>
+
 namespace audio_practice {
 
 struct CompressorSettings {
@@ -9,31 +16,128 @@ struct CompressorSettings {
     float release = 100.0f;    // ms
     float knee = 2.0f;         // dB
     float makeupGain = 0.0f;   // dB
+    DetectorMode detector = DetectorMode::Peak;
+    float rmsWindow = 10.0f;   // ms, Rms detector only
+};
+
+// CompressorSettings converted to the form the per-sample code uses: time
+// constants as one-pole coefficients and the gain curve in log2 units.
+// Shared by Compressor and CompressorBank so both compute identical gains.
+// The time constants are those of the peak detector.
+struct CompressorCurve {
+    float attackCoeff, releaseCoeff;
+    float threshold;
+    float kneeStart;
+    float invKnee;  // 1 / knee width; very large for a hard knee
+    float slope;    // 1 - 1/ratio
+    float makeup;
 };
 
+CompressorCurve makeCompressorCurve(const CompressorSettings& settings, float sampleRate);
+
+// Gain in log2 units for an envelope level. The soft knee is branch free:
+// kneeProgress is 0 below the knee, rises through it and saturates at 1
+// above, where the reduction is the full (input - threshold) * (1 - 1/ratio).
+inline float compressorGainLog2(float envelope, const CompressorCurve& c) {
+    float inputLog2 = simd::log2_ss(std::max(envelope, 1e-10f));
+    float kneeProgress = std::max(std::min((inputLog2 - c.kneeStart) * c.invKnee, 1.0f), 0.0f);
+    float gainReduction = (inputLog2 - c.threshold) * c.slope * kneeProgress * kneeProgress;
+    return c.makeup - gainReduction;
+}
+
+// Same curve for 8 lanes, operation for operation; parameters may differ per lane
+inline __m256 compressorGainLog2(__m256 envelope, __m256 threshold, __m256 kneeStart,
+                                 __m256 invKnee, __m256 slope, __m256 makeup) {
+    __m256 inputLog2 = simd::log2_ps(_mm256_max_ps(envelope, _mm256_set1_ps(1e-10f)));
+    __m256 kneeProgress = _mm256_mul_ps(_mm256_sub_ps(inputLog2, kneeStart), invKnee);
+    kneeProgress = _mm256_max_ps(_mm256_min_ps(kneeProgress, _mm256_set1_ps(1.0f)), _mm256_setzero_ps());
+    __m256 gainReduction = _mm256_mul_ps(_mm256_sub_ps(inputLog2, threshold), slope);
+    gainReduction = _mm256_mul_ps(_mm256_mul_ps(gainReduction, kneeProgress), kneeProgress);
+    return _mm256_sub_ps(makeup, gainReduction);
+}
+
 class Compressor {
 public:
+    // How channels are combined into the one detector that drives all of them
+    enum class LinkMode {
+        Max,  // loudest channel per sample
+        Sum   // mean of the channel levels, so a centered source reads as mono
+    };
+
     explicit Compressor(const CompressorSettings& settings = {});
     
+    // Set the sample rate and largest block size before processing.
+    // Recomputes time constants, sizes the detector buffer and clears the
+    // envelope. Larger blocks still work but are processed in pieces.
+    void prepare(float sampleRate, size_t maxBlockSize);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Clear the envelope follower
+    void reset();
+    
     void setSettings(const CompressorSettings& settings);
     const CompressorSettings& getSettings() const { return settings_; }
     
-    // Process audio buffer in-place
+    // Process audio buffer in-place. Runs in two passes per block: the
+    // serial envelope into a detector buffer, then the gain curve and gain
+    // 8 samples at a time. Output does not depend on how audio is blocked.
     void process(float* data, size_t numSamples);
     
-    // Get current gain reduction in dB
+    // Process several channels in-place with one linked detector; every
+    // channel gets the same gain, so the stereo image does not shift
+    void process(float* const* channels, size_t numChannels, size_t numSamples);
+    
+    // External sidechain: the detector reads sidechain, the gain is applied
+    // to data. The sidechain is read in place, never copied, so any view
+    // works, e.g. a pointer ahead into another track for lookahead ducking.
+    // It may alias data as long as it does not point behind it.
+    void process(const float* sidechain, float* data, size_t numSamples);
+    
+    // Multichannel sidechain, linked per getLinkMode() into one detector
+    // that drives every channel
+    void process(const float* const* sidechain, size_t numSidechainChannels,
+                 float* const* channels, size_t numChannels, size_t numSamples);
+    
+    // Apply the gain curve to an envelope computed elsewhere (e.g. one
+    // EnvelopeDetector shared by several processors) instead of running
+    // this compressor's own detector, whose state is left untouched
+    void applyEnvelope(const float* envelope, float* data, size_t numSamples);
+    void applyEnvelope(const float* envelope, float* const* channels,
+                       size_t numChannels, size_t numSamples);
+    
+    void setLinkMode(LinkMode mode) { linkMode_ = mode; }
+    LinkMode getLinkMode() const { return linkMode_; }
+    
+    // Get current gain reduction in dB (updated once per processed block)
     float getGainReduction() const { return currentGainReduction_; }
 
 private:
     CompressorSettings settings_;
-    float envelope_;
     float currentGainReduction_;
     
-    float attackCoeff_;
-    float releaseCoeff_;
+    CompressorCurve curve_;
+    
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    
+    LinkMode linkMode_ = LinkMode::Max;
+    
+    EnvelopeDetector detector_;
+    std::vector<float> gains_;  // envelope, then linear gain, per sample
+    std::vector<float> link_;   // combined channel level, same length
+    
+    void updateCoefficients();
     
-    void updateCoefficients(float sampleRate = 48000.0f);
-    float computeGain(float inputLevel);
+    // Pass 1: envelope of input into gains_
+    void detect(const float* input, size_t numSamples);
+    // Pass 2: gains_ envelope -> linear gain in place; returns the last
+    // sample's gain in log2 units
+    float computeGains(size_t numSamples);
+    void applyGains(float* data, size_t numSamples) const;
+    // Combined level of numChannels channels into link_
+    void linkChannels(const float* const* channels, size_t numChannels,
+                      size_t offset, size_t numSamples);
 };
 
 } // namespace audio_practice 
\ No newline at end of file
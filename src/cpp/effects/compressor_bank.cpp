@@ -0,0 +1,142 @@
+#include "effects/compressor_bank.h"
+#include "dsp/simd_math.h"
+#include <algorithm>
+#include <cstring>
+
+namespace audio_practice {
+
+CompressorBank::CompressorBank(size_t numCompressors) {
+    resize(numCompressors);
+}
+
+void CompressorBank::prepare(float sampleRate, size_t maxBlockSize) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    for (size_t k = 0; k < settings_.size(); ++k) {
+        updateLane(k);
+    }
+    reset();
+}
+
+void CompressorBank::resize(size_t numCompressors) {
+    const size_t oldSize = settings_.size();
+    settings_.resize(numCompressors);
+    
+    // New compressors and spare lanes of the last group (including lanes
+    // given up by shrinking) start from default settings and a clear
+    // envelope; spare lanes then run on silence
+    groups_.resize((numCompressors + kLanes - 1) / kLanes);
+    for (size_t k = std::min(oldSize, numCompressors); k < groups_.size() * kLanes; ++k) {
+        updateLane(k);
+        groups_[k / kLanes].envelope[k % kLanes] = 0.0f;
+        groups_[k / kLanes].gainLog2[k % kLanes] = 0.0f;
+    }
+}
+
+void CompressorBank::setSettings(size_t index, const CompressorSettings& settings) {
+    settings_[index] = settings;
+    updateLane(index);
+}
+
+void CompressorBank::updateLane(size_t index) {
+    CompressorCurve c = makeCompressorCurve(
+        index < settings_.size() ? settings_[index] : CompressorSettings{}, sampleRate_);
+    LaneGroup& group = groups_[index / kLanes];
+    const size_t lane = index % kLanes;
+    group.attackCoeff[lane] = c.attackCoeff;
+    group.releaseCoeff[lane] = c.releaseCoeff;
+    group.threshold[lane] = c.threshold;
+    group.kneeStart[lane] = c.kneeStart;
+    group.invKnee[lane] = c.invKnee;
+    group.slope[lane] = c.slope;
+    group.makeup[lane] = c.makeup;
+}
+
+void CompressorBank::reset() {
+    for (auto& group : groups_) {
+        std::fill(group.envelope, group.envelope + kLanes, 0.0f);
+        std::fill(group.gainLog2, group.gainLog2 + kLanes, 0.0f);
+    }
+}
+
+float CompressorBank::getGainReduction(size_t index) const {
+    return groups_[index / kLanes].gainLog2[index % kLanes] * kDbPerLog2;
+}
+
+void CompressorBank::process(float* const* channels, size_t numSamples) {
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        const size_t first = g * kLanes;
+        processGroup(groups_[g], channels + first, std::min(kLanes, settings_.size() - first), numSamples);
+    }
+}
+
+void CompressorBank::processGroup(LaneGroup& group, float* const* channels, size_t numChannels,
+                                  size_t numSamples) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 attackCoeff = _mm256_load_ps(group.attackCoeff);
+    const __m256 releaseCoeff = _mm256_load_ps(group.releaseCoeff);
+    const __m256 attackInput = _mm256_sub_ps(one, attackCoeff);
+    const __m256 releaseInput = _mm256_sub_ps(one, releaseCoeff);
+    const __m256 threshold = _mm256_load_ps(group.threshold);
+    const __m256 kneeStart = _mm256_load_ps(group.kneeStart);
+    const __m256 invKnee = _mm256_load_ps(group.invKnee);
+    const __m256 slope = _mm256_load_ps(group.slope);
+    const __m256 makeup = _mm256_load_ps(group.makeup);
+    
+    // Per lane, the same min/max envelope selection as Compressor::detect
+    const __m256 attackFaster = _mm256_cmp_ps(attackCoeff, releaseCoeff, _CMP_LE_OQ);
+    
+    __m256 envelope = _mm256_load_ps(group.envelope);
+    __m256 gainLog2 = _mm256_load_ps(group.gainLog2);
+    
+    // Tile: rows[c] holds 8 consecutive samples of channel c; after the
+    // transpose rows[j] holds sample j of all 8 channels
+    __m256 rows[kLanes];
+    alignas(32) float partial[kLanes][kLanes];
+    
+    for (size_t i = 0; i < numSamples; i += kLanes) {
+        const size_t count = std::min(kLanes, numSamples - i);
+        
+        for (size_t c = 0; c < kLanes; ++c) {
+            if (c >= numChannels) {
+                rows[c] = _mm256_setzero_ps();
+            } else if (count == kLanes) {
+                rows[c] = _mm256_loadu_ps(channels[c] + i);
+            } else {
+                std::fill(partial[c], partial[c] + kLanes, 0.0f);
+                std::memcpy(partial[c], channels[c] + i, count * sizeof(float));
+                rows[c] = _mm256_load_ps(partial[c]);
+            }
+        }
+        simd::transpose8x8_ps(rows);
+        
+        for (size_t j = 0; j < count; ++j) {
+            __m256 level = _mm256_and_ps(rows[j], absMask);
+            __m256 attacked = _mm256_fmadd_ps(attackCoeff, envelope, _mm256_mul_ps(attackInput, level));
+            __m256 released = _mm256_fmadd_ps(releaseCoeff, envelope, _mm256_mul_ps(releaseInput, level));
+            envelope = _mm256_blendv_ps(_mm256_min_ps(attacked, released),
+                                        _mm256_max_ps(attacked, released), attackFaster);
+            
+            gainLog2 = compressorGainLog2(envelope, threshold, kneeStart, invKnee, slope, makeup);
+            rows[j] = _mm256_mul_ps(rows[j], simd::exp2_ps(gainLog2));
+        }
+        
+        simd::transpose8x8_ps(rows);
+        for (size_t c = 0; c < numChannels; ++c) {
+            if (count == kLanes) {
+                _mm256_storeu_ps(channels[c] + i, rows[c]);
+            } else {
+                _mm256_store_ps(partial[c], rows[c]);
+                std::memcpy(channels[c] + i, partial[c], count * sizeof(float));
+            }
+        }
+    }
+    
+    _mm256_store_ps(group.envelope, envelope);
+    if (numSamples > 0) {
+        _mm256_store_ps(group.gainLog2, gainLog2);
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "effects/compressor.h"
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+// Many independent mono compressors, e.g. one per track of a large session,
+// advanced 8 at a time: settings and envelopes are stored structure-of-arrays
+// so each AVX2 lane is one compressor. Audio is moved between channel-major
+// buffers and lanes through 8x8 transposes.
+// Output matches a Compressor per channel bit for bit. Lanes always use the
+// peak detector; CompressorSettings::detector is ignored.
+class CompressorBank {
+public:
+    explicit CompressorBank(size_t numCompressors = 0);
+    
+    // Set the sample rate and largest block size before processing.
+    // Recomputes time constants and clears all envelopes.
+    void prepare(float sampleRate, size_t maxBlockSize);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Change the number of compressors; new ones get default settings and a
+    // clear envelope, also when a shrink is followed by a grow
+    void resize(size_t numCompressors);
+    size_t size() const { return settings_.size(); }
+    
+    void setSettings(size_t index, const CompressorSettings& settings);
+    const CompressorSettings& getSettings(size_t index) const { return settings_[index]; }
+    
+    // Clear all envelope followers
+    void reset();
+    
+    // Process size() channels in-place, channels[k] through compressor k
+    void process(float* const* channels, size_t numSamples);
+    
+    // Gain reduction of one compressor in dB (updated once per processed block)
+    float getGainReduction(size_t index) const;
+
+private:
+    static constexpr size_t kLanes = 8;
+    
+    struct LaneGroup {
+        alignas(32) float attackCoeff[kLanes];
+        alignas(32) float releaseCoeff[kLanes];
+        alignas(32) float threshold[kLanes];
+        alignas(32) float kneeStart[kLanes];
+        alignas(32) float invKnee[kLanes];
+        alignas(32) float slope[kLanes];
+        alignas(32) float makeup[kLanes];
+        alignas(32) float envelope[kLanes];
+        alignas(32) float gainLog2[kLanes];  // last processed sample, for metering
+    };
+    
+    std::vector<CompressorSettings> settings_;
+    std::vector<LaneGroup> groups_;
+    
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    
+    void updateLane(size_t index);
+    void processGroup(LaneGroup& group, float* const* channels, size_t numChannels, size_t numSamples);
+};
+
+} // namespace audio_practice
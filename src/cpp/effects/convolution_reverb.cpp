@@ -0,0 +1,92 @@
+#include "effects/convolution_reverb.h"
+#include <algorithm>
+#include <cmath>
+
+namespace audio_practice {
+
+ConvolutionReverb::ConvolutionReverb(const ConvolutionReverbSettings& settings)
+    : settings_(settings) {
+    updateGains();
+}
+
+void ConvolutionReverb::prepare(float sampleRate, size_t maxBlockSize) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    wet_.assign(std::max(maxBlockSize, settings_.headSize), 0.0f);
+    reset();
+}
+
+void ConvolutionReverb::setImpulseResponse(const float* ir, size_t length) {
+    ir_.assign(ir, ir + length);
+    rebuildEngine();
+}
+
+void ConvolutionReverb::setSettings(const ConvolutionReverbSettings& settings) {
+    bool rebuild = settings.headSize != settings_.headSize ||
+                   settings.maxPartitionSize != settings_.maxPartitionSize ||
+                   settings.asyncTail != settings_.asyncTail;
+    settings_ = settings;
+    updateGains();
+    if (rebuild) {
+        rebuildEngine();
+    }
+}
+
+void ConvolutionReverb::updateGains() {
+    wetGain_ = std::pow(10.0f, settings_.wetLevel / 20.0f);
+    dryGain_ = std::pow(10.0f, settings_.dryLevel / 20.0f);
+}
+
+void ConvolutionReverb::rebuildEngine() {
+    engine_.reset();
+    if (ir_.empty()) {
+        dryDelay_.clear();
+        return;
+    }
+    
+    engine_ = std::make_unique<ConvolutionEngine>(ir_.data(), ir_.size(), settings_.headSize,
+                                                  settings_.maxPartitionSize, settings_.asyncTail);
+    dryDelay_.assign(engine_->getLatency(), 0.0f);
+    dryPos_ = 0;
+    
+    if (wet_.size() < settings_.headSize) {
+        wet_.assign(settings_.headSize, 0.0f);
+    }
+}
+
+void ConvolutionReverb::reset() {
+    if (engine_) {
+        engine_->reset();
+    }
+    std::fill(dryDelay_.begin(), dryDelay_.end(), 0.0f);
+    dryPos_ = 0;
+}
+
+void ConvolutionReverb::process(float* data, size_t numSamples) {
+    if (!engine_) {
+        for (size_t i = 0; i < numSamples; ++i) {
+            data[i] *= dryGain_;
+        }
+        return;
+    }
+    
+    const size_t latency = dryDelay_.size();
+    
+    // Blocks larger than prepared are split to fit the scratch buffer
+    while (numSamples > 0) {
+        const size_t n = std::min(numSamples, wet_.size());
+        engine_->process(data, wet_.data(), n);
+        
+        for (size_t i = 0; i < n; ++i) {
+            float dry = dryDelay_[dryPos_];
+            dryDelay_[dryPos_] = data[i];
+            dryPos_ = (dryPos_ + 1 == latency) ? 0 : dryPos_ + 1;
+            data[i] = dryGain_ * dry + wetGain_ * wet_[i];
+        }
+        
+        data += n;
+        numSamples -= n;
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "dsp/convolution_engine.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace audio_practice {
+
+struct ConvolutionReverbSettings {
+    float wetLevel = -6.0f;          // dB
+    float dryLevel = 0.0f;           // dB
+    size_t headSize = 128;           // samples; also the latency
+    size_t maxPartitionSize = 8192;  // samples
+    bool asyncTail = true;           // compute tail partitions on the engine's own worker thread
+};
+
+// Convolution reverb over a mono impulse response. The head partition runs
+// in the calling thread; with asyncTail the larger tail partitions run on a
+// worker thread owned by the engine (never a shared pool, so mixes queued on
+// ThreadPool::shared() cannot delay them), and long IRs cost the audio
+// thread little more than a short one. The dry path is delayed to stay
+// aligned with the wet path.
+class ConvolutionReverb {
+public:
+    explicit ConvolutionReverb(const ConvolutionReverbSettings& settings = {});
+    
+    // Set the sample rate and largest block size before processing.
+    // Clears the reverb tail.
+    void prepare(float sampleRate, size_t maxBlockSize);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Copy an impulse response recorded at the prepared sample rate.
+    // Rebuilds the partitioning; not real-time safe.
+    void setImpulseResponse(const float* ir, size_t length);
+    size_t getImpulseResponseLength() const { return ir_.size(); }
+    
+    // Partition changes rebuild the engine; level changes apply immediately
+    void setSettings(const ConvolutionReverbSettings& settings);
+    const ConvolutionReverbSettings& getSettings() const { return settings_; }
+    
+    // Clear the reverb tail
+    void reset();
+    
+    // Process audio buffer in-place
+    void process(float* data, size_t numSamples);
+    
+    // Delay of both wet and dry output, in samples (0 without an IR)
+    size_t getLatency() const { return engine_ ? engine_->getLatency() : 0; }
+
+private:
+    ConvolutionReverbSettings settings_;
+    std::vector<float> ir_;
+    std::unique_ptr<ConvolutionEngine> engine_;
+    
+    std::vector<float> wet_;       // engine output scratch
+    std::vector<float> dryDelay_;  // latency-length ring
+    size_t dryPos_ = 0;
+    
+    float wetGain_;
+    float dryGain_;
+    
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    
+    void rebuildEngine();
+    void updateGains();
+};
+
+} // namespace audio_practice
@@ -1,68 +1,554 @@
 #include "effects/equalizer.h"
+#include "dsp/coefficient_cache.h"
+#include "dsp/simd_math.h"
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <immintrin.h>
 
 namespace audio_practice {
 
+namespace {
+
+// Bands whose coefficients are computed per SIMD call
+constexpr size_t kCoeffBatchSize = 8;
+
+// Samples between coefficient updates while ramping
+constexpr size_t kSmoothingBlockSize = 32;
+
+// Coefficients `remaining` samples before reaching target
+BiquadCoeffs rampCoeffs(const BiquadCoeffs& target, const BiquadCoeffs& step, float remaining) {
+    BiquadCoeffs c;
+    c.a0 = target.a0 - step.a0 * remaining;
+    c.a1 = target.a1 - step.a1 * remaining;
+    c.a2 = target.a2 - step.a2 * remaining;
+    c.b1 = target.b1 - step.b1 * remaining;
+    c.b2 = target.b2 - step.b2 * remaining;
+    return c;
+}
+
+// Cache key: everything calculateCoeffs depends on
+struct BandKey {
+    float frequency;
+    float gain;
+    float q;
+    float sampleRate;
+    int type;
+    
+    bool operator==(const BandKey& other) const {
+        return frequency == other.frequency && gain == other.gain && q == other.q &&
+               sampleRate == other.sampleRate && type == other.type;
+    }
+};
+
+struct BandKeyHash {
+    size_t operator()(const BandKey& key) const {
+        std::hash<float> h;
+        size_t seed = std::hash<int>()(key.type);
+        for (float v : {key.frequency, key.gain, key.q, key.sampleRate}) {
+            seed ^= h(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+using BandCoeffCache = CoefficientCache<BandKey, BiquadCoeffs, BandKeyHash>;
+
+// Shared by every Equalizer in the process
+BandCoeffCache& sharedCoeffCache() {
+    static BandCoeffCache cache;
+    return cache;
+}
+
+BandKey makeKey(const EQBand& band, float sampleRate) {
+    return {band.frequency, band.gain, band.q, sampleRate, static_cast<int>(band.type)};
+}
+
+} // namespace
+
 Equalizer::Equalizer() {
     // Initialize empty
 }
 
+void Equalizer::prepare(float sampleRate, size_t maxBlockSize, size_t numChannels) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    
+    // Multichannel process() then runs without allocating
+    channelStates_.resize(numChannels > 1 ? numChannels - 1 : 0);
+    channelSvfStates_.resize(channelStates_.size());
+    for (size_t ch = 0; ch < channelStates_.size(); ++ch) {
+        channelStates_[ch].resize(bands_.size());
+        channelSvfStates_[ch].resize(bands_.size());
+    }
+    rampStart_.reserve(bands_.size());
+    svfRampStart_.reserve(bands_.size());
+    
+    std::fill(dirty_.begin(), dirty_.end(), 1);
+    hasDirtyBands_ = !bands_.empty();
+    reset();
+    
+    // Setup time: bands already present go through the shared cache here
+    // rather than on the first process() call
+    if (hasDirtyBands_) {
+        updateCoefficients(true);
+    }
+}
+
 void Equalizer::setBand(size_t index, const EQBand& band) {
     if (index >= bands_.size()) {
         bands_.resize(index + 1);
         coeffs_.resize(index + 1);
+        targetCoeffs_.resize(index + 1);
+        coeffSteps_.resize(index + 1);
         states_.resize(index + 1);
+        svfCoeffs_.resize(index + 1);
+        svfTargets_.resize(index + 1);
+        svfSteps_.resize(index + 1);
+        svfStates_.resize(index + 1);
+        dirty_.resize(index + 1, 0);
+        blockStale_.resize(index + 1, 1);
+        for (size_t ch = 0; ch < channelStates_.size(); ++ch) {
+            channelStates_[ch].resize(index + 1);
+            channelSvfStates_[ch].resize(index + 1);
+        }
+        rampStart_.reserve(index + 1);
+        svfRampStart_.reserve(index + 1);
     }
     
     bands_[index] = band;
-    updateCoefficients();
+    dirty_[index] = 1;
+    hasDirtyBands_ = true;
+}
+
+void Equalizer::setBands(const std::vector<EQBand>& bands) {
+    if (bands.size() != bands_.size()) {
+        clearBands();
+        reset();
+    }
+    for (size_t i = 0; i < bands.size(); ++i) {
+        setBand(i, bands[i]);
+    }
+    if (hasDirtyBands_) {
+        updateCoefficients(true);
+    }
 }
 
 void Equalizer::clearBands() {
     bands_.clear();
     coeffs_.clear();
+    targetCoeffs_.clear();
+    coeffSteps_.clear();
     states_.clear();
+    blockCoeffs_.clear();
+    svfCoeffs_.clear();
+    svfTargets_.clear();
+    svfSteps_.clear();
+    svfStates_.clear();
+    for (size_t ch = 0; ch < channelStates_.size(); ++ch) {
+        channelStates_[ch].clear();
+        channelSvfStates_[ch].clear();
+    }
+    dirty_.clear();
+    blockStale_.clear();
+    hasDirtyBands_ = false;
+    smoothingRemaining_ = 0;
+}
+
+void Equalizer::reset() {
+    std::fill(states_.begin(), states_.end(), BiquadState{});
+    std::fill(svfStates_.begin(), svfStates_.end(), SvfState{});
+    for (auto& states : channelStates_) {
+        std::fill(states.begin(), states.end(), BiquadState{});
+    }
+    for (auto& states : channelSvfStates_) {
+        std::fill(states.begin(), states.end(), SvfState{});
+    }
+    active_ = false;
+    
+    if (smoothingRemaining_ > 0) {
+        smoothingRemaining_ = 0;
+        coeffs_ = targetCoeffs_;
+        svfCoeffs_ = svfTargets_;
+        refreshBlockCoeffs();
+    }
+}
+
+bool Equalizer::isQuiescent(float threshold) const {
+    auto quiet = [threshold](const std::vector<BiquadState>& states,
+                             const std::vector<SvfState>& svfStates) {
+        for (const auto& state : states) {
+            if (std::abs(state.s1) > threshold || std::abs(state.s2) > threshold) {
+                return false;
+            }
+        }
+        for (const auto& state : svfStates) {
+            if (std::abs(state.ic1eq) > threshold || std::abs(state.ic2eq) > threshold) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    if (!quiet(states_, svfStates_)) {
+        return false;
+    }
+    for (size_t ch = 0; ch < channelStates_.size(); ++ch) {
+        if (!quiet(channelStates_[ch], channelSvfStates_[ch])) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void Equalizer::updateCoefficients(float sampleRate) {
+void Equalizer::setProcessingMode(ProcessingMode mode) {
+    mode_ = mode;
+    std::fill(blockStale_.begin(), blockStale_.end(), 1);
+    // Mid-ramp, the matrices are built from the target once the ramp ends
+    if (smoothingRemaining_ == 0) {
+        refreshBlockCoeffs();
+    }
+}
+
+void Equalizer::setTopology(Topology topology) {
+    if (topology == topology_) {
+        return;
+    }
+    topology_ = topology;
+    
+    // The other structure's coefficients may be stale
+    std::fill(dirty_.begin(), dirty_.end(), 1);
+    hasDirtyBands_ = !bands_.empty();
+    reset();
+}
+
+void Equalizer::updateCoefficients(bool useCache) {
+    // Only bands whose parameters changed pay for sin/cos/pow. The shared
+    // cache takes a lock and may allocate, so only setup-time updates use
+    // it; updates made from process() (e.g. automation) compute directly.
+    BandCoeffCache& cache = sharedCoeffCache();
+    size_t batch[kCoeffBatchSize];
+    size_t count = 0;
+    for (size_t i = 0; i < bands_.size(); ++i) {
+        if (!dirty_[i]) {
+            continue;
+        }
+        dirty_[i] = 0;
+        blockStale_[i] = 1;
+        if (topology_ == Topology::StateVariable) {
+            svfTargets_[i] = calculateSvfCoeffs(bands_[i], sampleRate_);
+        }
+        if (useCache && cache.find(makeKey(bands_[i], sampleRate_), targetCoeffs_[i])) {
+            continue;
+        }
+        batch[count++] = i;
+        if (count == kCoeffBatchSize) {
+            calculateCoeffsBatch(batch, count, useCache);
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        calculateCoeffsBatch(batch, count, useCache);
+    }
+    hasDirtyBands_ = false;
+    
+    // Before any audio has run there is nothing to smooth
+    if (!active_ || smoothingLength_ == 0) {
+        coeffs_ = targetCoeffs_;
+        svfCoeffs_ = svfTargets_;
+        smoothingRemaining_ = 0;
+        refreshBlockCoeffs();
+        return;
+    }
+    
+    const float invLength = 1.0f / static_cast<float>(smoothingLength_);
+    smoothingRemaining_ = smoothingLength_;
+    
+    // The SVF ramps its own parameters per sample
+    if (topology_ == Topology::StateVariable) {
+        coeffs_ = targetCoeffs_;
+        for (size_t i = 0; i < bands_.size(); ++i) {
+            const SvfCoeffs& from = svfCoeffs_[i];
+            const SvfCoeffs& to = svfTargets_[i];
+            SvfCoeffs& step = svfSteps_[i];
+            step.g = (to.g - from.g) * invLength;
+            step.k = (to.k - from.k) * invLength;
+            step.m0 = (to.m0 - from.m0) * invLength;
+            step.m1 = (to.m1 - from.m1) * invLength;
+            step.m2 = (to.m2 - from.m2) * invLength;
+        }
+        return;
+    }
+    
+    // (Re)start the ramp from wherever the coefficients are now. The stable
+    // region of (b1, b2) is convex, so every intermediate filter is stable.
     for (size_t i = 0; i < bands_.size(); ++i) {
-        coeffs_[i] = calculateCoeffs(bands_[i], sampleRate);
+        const BiquadCoeffs& from = coeffs_[i];
+        const BiquadCoeffs& to = targetCoeffs_[i];
+        BiquadCoeffs& step = coeffSteps_[i];
+        step.a0 = (to.a0 - from.a0) * invLength;
+        step.a1 = (to.a1 - from.a1) * invLength;
+        step.a2 = (to.a2 - from.a2) * invLength;
+        step.b1 = (to.b1 - from.b1) * invLength;
+        step.b2 = (to.b2 - from.b2) * invLength;
     }
 }
 
-Equalizer::BiquadCoeffs Equalizer::calculateCoeffs(const EQBand& band, float sampleRate) {
-    BiquadCoeffs coeffs;
+void Equalizer::calculateCoeffsBatch(const size_t* indices, size_t count, bool cacheResults) {
+    alignas(32) float freq[kCoeffBatchSize];
+    alignas(32) float gain[kCoeffBatchSize];
+    alignas(32) float q[kCoeffBatchSize];
+    alignas(32) int type[kCoeffBatchSize];
+    
+    for (size_t k = 0; k < kCoeffBatchSize; ++k) {
+        // Unused lanes get a harmless default band
+        const EQBand band = (k < count) ? bands_[indices[k]] : EQBand{};
+        freq[k] = band.frequency;
+        gain[k] = band.gain;
+        q[k] = band.q;
+        type[k] = static_cast<int>(band.type);
+    }
+    
+    // omega = 2*pi*f/fs, alpha = sin(omega)/(2q), A = 10^(gain/40)
+    __m256 omega = _mm256_mul_ps(_mm256_load_ps(freq),
+                                 _mm256_set1_ps(static_cast<float>(2.0 * M_PI) / sampleRate_));
+    __m256 sinOmega, cosOmega;
+    simd::sincos_ps(omega, sinOmega, cosOmega);
+    __m256 alpha = _mm256_div_ps(sinOmega, _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_load_ps(q)));
+    __m256 A = simd::exp2_ps(_mm256_mul_ps(_mm256_load_ps(gain),
+                                           _mm256_set1_ps(static_cast<float>(std::log2(10.0) / 40.0))));
+    
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    
+    // Peaking filter (also the fallback for any lane not matched below)
+    __m256 alphaA = _mm256_mul_ps(alpha, A);
+    __m256 alphaOverA = _mm256_div_ps(alpha, A);
+    __m256 twoCos = _mm256_mul_ps(two, cosOmega);
+    __m256 nb0 = _mm256_add_ps(one, alphaA);
+    __m256 nb1 = _mm256_sub_ps(_mm256_setzero_ps(), twoCos);
+    __m256 nb2 = _mm256_sub_ps(one, alphaA);
+    __m256 na0 = _mm256_add_ps(one, alphaOverA);
+    __m256 na1 = nb1;
+    __m256 na2 = _mm256_sub_ps(one, alphaOverA);
     
+    auto select = [&type](int t) {
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(type)), _mm256_set1_epi32(t)));
+    };
+    auto blend = [&](__m256 mask, __m256 b0, __m256 b1, __m256 b2, __m256 a0, __m256 a1, __m256 a2) {
+        nb0 = _mm256_blendv_ps(nb0, b0, mask);
+        nb1 = _mm256_blendv_ps(nb1, b1, mask);
+        nb2 = _mm256_blendv_ps(nb2, b2, mask);
+        na0 = _mm256_blendv_ps(na0, a0, mask);
+        na1 = _mm256_blendv_ps(na1, a1, mask);
+        na2 = _mm256_blendv_ps(na2, a2, mask);
+    };
+    
+    // Low/high pass share their denominator
+    {
+        __m256 a0 = _mm256_add_ps(one, alpha);
+        __m256 a1 = _mm256_sub_ps(_mm256_setzero_ps(), twoCos);
+        __m256 a2 = _mm256_sub_ps(one, alpha);
+        __m256 lp = _mm256_mul_ps(half, _mm256_sub_ps(one, cosOmega));
+        __m256 hp = _mm256_mul_ps(half, _mm256_add_ps(one, cosOmega));
+        blend(select(EQBand::LOW_PASS), lp, _mm256_add_ps(lp, lp), lp, a0, a1, a2);
+        blend(select(EQBand::HIGH_PASS), hp, _mm256_sub_ps(_mm256_setzero_ps(), _mm256_add_ps(hp, hp)),
+              hp, a0, a1, a2);
+    }
+    
+    // Shelves
+    {
+        __m256 ap1 = _mm256_add_ps(A, one);
+        __m256 am1 = _mm256_sub_ps(A, one);
+        __m256 ap1Cos = _mm256_mul_ps(ap1, cosOmega);
+        __m256 am1Cos = _mm256_mul_ps(am1, cosOmega);
+        __m256 shelfAlpha = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sqrt_ps(A)), alpha);
+        __m256 twoA = _mm256_mul_ps(two, A);
+        
+        __m256 lowPlus = _mm256_sub_ps(ap1, am1Cos);   // (A+1) - (A-1)cos
+        __m256 lowMinus = _mm256_add_ps(ap1, am1Cos);  // (A+1) + (A-1)cos
+        blend(select(EQBand::LOW_SHELF),
+              _mm256_mul_ps(A, _mm256_add_ps(lowPlus, shelfAlpha)),
+              _mm256_mul_ps(twoA, _mm256_sub_ps(am1, ap1Cos)),
+              _mm256_mul_ps(A, _mm256_sub_ps(lowPlus, shelfAlpha)),
+              _mm256_add_ps(lowMinus, shelfAlpha),
+              _mm256_mul_ps(_mm256_set1_ps(-2.0f), _mm256_add_ps(am1, ap1Cos)),
+              _mm256_sub_ps(lowMinus, shelfAlpha));
+        blend(select(EQBand::HIGH_SHELF),
+              _mm256_mul_ps(A, _mm256_add_ps(lowMinus, shelfAlpha)),
+              _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), twoA), _mm256_add_ps(am1, ap1Cos)),
+              _mm256_mul_ps(A, _mm256_sub_ps(lowMinus, shelfAlpha)),
+              _mm256_add_ps(lowPlus, shelfAlpha),
+              _mm256_mul_ps(two, _mm256_sub_ps(am1, ap1Cos)),
+              _mm256_sub_ps(lowPlus, shelfAlpha));
+    }
+    
+    // Normalize by the denominator's leading coefficient
+    __m256 invA0 = _mm256_div_ps(one, na0);
+    alignas(32) float a0[kCoeffBatchSize], a1[kCoeffBatchSize], a2[kCoeffBatchSize];
+    alignas(32) float fb1[kCoeffBatchSize], fb2[kCoeffBatchSize];
+    _mm256_store_ps(a0, _mm256_mul_ps(nb0, invA0));
+    _mm256_store_ps(a1, _mm256_mul_ps(nb1, invA0));
+    _mm256_store_ps(a2, _mm256_mul_ps(nb2, invA0));
+    _mm256_store_ps(fb1, _mm256_mul_ps(na1, invA0));
+    _mm256_store_ps(fb2, _mm256_mul_ps(na2, invA0));
+    
+    for (size_t k = 0; k < count; ++k) {
+        const size_t index = indices[k];
+        BiquadCoeffs& coeffs = targetCoeffs_[index];
+        coeffs.a0 = a0[k];
+        coeffs.a1 = a1[k];
+        coeffs.a2 = a2[k];
+        coeffs.b1 = fb1[k];
+        coeffs.b2 = fb2[k];
+        if (cacheResults) {
+            sharedCoeffCache().insert(makeKey(bands_[index], sampleRate_), coeffs);
+        }
+    }
+}
+
+void Equalizer::refreshBlockCoeffs() {
+    // State-space matrices are only needed by the block-parallel kernel
+    if (mode_ != ProcessingMode::BlockParallel) {
+        return;
+    }
+    
+    blockCoeffs_.resize(coeffs_.size());
+    for (size_t i = 0; i < coeffs_.size(); ++i) {
+        if (blockStale_[i]) {
+            blockCoeffs_[i] = makeBiquadBlockCoeffs(coeffs_[i]);
+            blockStale_[i] = 0;
+        }
+    }
+}
+
+void Equalizer::computeMagnitudeResponse(const float* frequencies, float* magnitudes, size_t count) {
+    if (hasDirtyBands_) {
+        updateCoefficients(true);
+    }
+    
+    // Describe where the filter is heading, not a mid-ramp snapshot
+    computeCascadeMagnitude(targetCoeffs_.data(), targetCoeffs_.size(), sampleRate_,
+                            frequencies, magnitudes, count);
+}
+
+BiquadCoeffs Equalizer::calculateCoeffs(const EQBand& band, float sampleRate) {
+    // RBJ audio EQ cookbook designs
     float omega = 2.0f * M_PI * band.frequency / sampleRate;
     float sin_omega = std::sin(omega);
     float cos_omega = std::cos(omega);
     float alpha = sin_omega / (2.0f * band.q);
     float A = std::pow(10.0f, band.gain / 40.0f);
     
+    float b0, b1, b2, a0, a1, a2;
+    
     switch (band.type) {
-        case EQBand::PEAK: {
-            float b0 = 1.0f + alpha * A;
-            float b1 = -2.0f * cos_omega;
-            float b2 = 1.0f - alpha * A;
-            float a0 = 1.0f + alpha / A;
-            float a1 = -2.0f * cos_omega;
-            float a2 = 1.0f - alpha / A;
-            
-            // Normalize
-            coeffs.a0 = b0 / a0;
-            coeffs.a1 = b1 / a0;
-            coeffs.a2 = b2 / a0;
-            coeffs.b1 = a1 / a0;
-            coeffs.b2 = a2 / a0;
+        case EQBand::HIGH_SHELF: {
+            float shelfAlpha = 2.0f * std::sqrt(A) * alpha;
+            b0 = A * ((A + 1.0f) + (A - 1.0f) * cos_omega + shelfAlpha);
+            b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cos_omega);
+            b2 = A * ((A + 1.0f) + (A - 1.0f) * cos_omega - shelfAlpha);
+            a0 = (A + 1.0f) - (A - 1.0f) * cos_omega + shelfAlpha;
+            a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cos_omega);
+            a2 = (A + 1.0f) - (A - 1.0f) * cos_omega - shelfAlpha;
+            break;
+        }
+        case EQBand::LOW_SHELF: {
+            float shelfAlpha = 2.0f * std::sqrt(A) * alpha;
+            b0 = A * ((A + 1.0f) - (A - 1.0f) * cos_omega + shelfAlpha);
+            b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cos_omega);
+            b2 = A * ((A + 1.0f) - (A - 1.0f) * cos_omega - shelfAlpha);
+            a0 = (A + 1.0f) + (A - 1.0f) * cos_omega + shelfAlpha;
+            a1 = -2.0f * ((A - 1.0f) + (A + 1.0f) * cos_omega);
+            a2 = (A + 1.0f) + (A - 1.0f) * cos_omega - shelfAlpha;
+            break;
+        }
+        case EQBand::HIGH_PASS: {
+            b0 = (1.0f + cos_omega) / 2.0f;
+            b1 = -(1.0f + cos_omega);
+            b2 = (1.0f + cos_omega) / 2.0f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cos_omega;
+            a2 = 1.0f - alpha;
             break;
         }
+        case EQBand::LOW_PASS: {
+            b0 = (1.0f - cos_omega) / 2.0f;
+            b1 = 1.0f - cos_omega;
+            b2 = (1.0f - cos_omega) / 2.0f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cos_omega;
+            a2 = 1.0f - alpha;
+            break;
+        }
+        case EQBand::PEAK:
+        default: {
+            b0 = 1.0f + alpha * A;
+            b1 = -2.0f * cos_omega;
+            b2 = 1.0f - alpha * A;
+            a0 = 1.0f + alpha / A;
+            a1 = -2.0f * cos_omega;
+            a2 = 1.0f - alpha / A;
+            break;
+        }
+    }
+    
+    // Normalize
+    BiquadCoeffs coeffs;
+    coeffs.a0 = b0 / a0;
+    coeffs.a1 = b1 / a0;
+    coeffs.a2 = b2 / a0;
+    coeffs.b1 = a1 / a0;
+    coeffs.b2 = a2 / a0;
+    
+    return coeffs;
+}
+
+SvfCoeffs Equalizer::calculateSvfCoeffs(const EQBand& band, float sampleRate) {
+    // Simper's mixing coefficients; one tan per change
+    float g = std::tan(static_cast<float>(M_PI) * band.frequency / sampleRate);
+    float k = 1.0f / band.q;
+    float A = std::pow(10.0f, band.gain / 40.0f);
+    
+    SvfCoeffs coeffs;
+    switch (band.type) {
+        case EQBand::HIGH_SHELF:
+            coeffs.g = g * std::sqrt(A);
+            coeffs.k = k;
+            coeffs.m0 = A * A;
+            coeffs.m1 = k * (1.0f - A) * A;
+            coeffs.m2 = 1.0f - A * A;
+            break;
+        case EQBand::LOW_SHELF:
+            coeffs.g = g / std::sqrt(A);
+            coeffs.k = k;
+            coeffs.m0 = 1.0f;
+            coeffs.m1 = k * (A - 1.0f);
+            coeffs.m2 = A * A - 1.0f;
+            break;
+        case EQBand::HIGH_PASS:
+            coeffs.g = g;
+            coeffs.k = k;
+            coeffs.m0 = 1.0f;
+            coeffs.m1 = -k;
+            coeffs.m2 = -1.0f;
+            break;
+        case EQBand::LOW_PASS:
+            coeffs.g = g;
+            coeffs.k = k;
+            coeffs.m0 = 0.0f;
+            coeffs.m1 = 0.0f;
+            coeffs.m2 = 1.0f;
+            break;
+        case EQBand::PEAK:
         default:
-            // Passthrough for unimplemented types
-            coeffs.a0 = 1.0f;
-            coeffs.a1 = 0.0f;
-            coeffs.a2 = 0.0f;
-            coeffs.b1 = 0.0f;
-            coeffs.b2 = 0.0f;
+            coeffs.g = g;
+            coeffs.k = 1.0f / (band.q * A);
+            coeffs.m0 = 1.0f;
+            coeffs.m1 = coeffs.k * (A * A - 1.0f);
+            coeffs.m2 = 0.0f;
             break;
     }
     
@@ -70,25 +556,96 @@ Equalizer::BiquadCoeffs Equalizer::calculateCoeffs(const EQBand& band, float sam
 }
 
 void Equalizer::process(float* data, size_t numSamples) {
-    for (size_t band = 0; band < bands_.size(); ++band) {
-        auto& coeffs = coeffs_[band];
-        auto& state = states_[band];
-        
-        for (size_t i = 0; i < numSamples; ++i) {
-            float input = data[i];
-            
-            // Biquad filter equation
-            float output = coeffs.a0 * input + coeffs.a1 * state.x1 + coeffs.a2 * state.x2
-                         - coeffs.b1 * state.y1 - coeffs.b2 * state.y2;
-            
-            // Update state
-            state.x2 = state.x1;
-            state.x1 = input;
-            state.y2 = state.y1;
-            state.y1 = output;
+    if (hasDirtyBands_) {
+        updateCoefficients();
+    }
+    active_ = true;
+    
+    if (topology_ == Topology::StateVariable) {
+        // Coefficients ramp per sample; no sub-blocking or state reset needed
+        if (smoothingRemaining_ > 0) {
+            size_t n = std::min(numSamples, smoothingRemaining_);
+            processSvfCascadeRamp(svfCoeffs_.data(), svfSteps_.data(), svfStates_.data(),
+                                  bands_.size(), data, n);
+            smoothingRemaining_ -= n;
+            data += n;
+            numSamples -= n;
             
-            data[i] = output;
+            if (smoothingRemaining_ == 0) {
+                svfCoeffs_ = svfTargets_;
+            }
+        }
+        
+        processSvfCascade(svfCoeffs_.data(), svfStates_.data(), bands_.size(), data, numSamples);
+        return;
+    }
+    
+    // Ramp towards new coefficients in short sub-blocks to avoid zipper noise
+    while (smoothingRemaining_ > 0 && numSamples > 0) {
+        size_t n = std::min({numSamples, kSmoothingBlockSize, smoothingRemaining_});
+        smoothingRemaining_ -= n;
+        
+        const float remaining = static_cast<float>(smoothingRemaining_);
+        for (size_t b = 0; b < coeffs_.size(); ++b) {
+            coeffs_[b] = rampCoeffs(targetCoeffs_[b], coeffSteps_[b], remaining);
         }
+        processBiquadCascade(coeffs_.data(), states_.data(), bands_.size(), data, n);
+        
+        data += n;
+        numSamples -= n;
+        
+        if (smoothingRemaining_ == 0) {
+            coeffs_ = targetCoeffs_;
+            refreshBlockCoeffs();
+        }
+    }
+    
+    if (mode_ == ProcessingMode::BlockParallel) {
+        processBiquadCascadeBlockParallel(blockCoeffs_.data(), states_.data(), bands_.size(),
+                                          data, numSamples);
+        return;
+    }
+    
+    // All bands run per sample in one pass over the buffer
+    processBiquadCascade(coeffs_.data(), states_.data(), bands_.size(), data, numSamples);
+}
+
+void Equalizer::process(float* const* channels, size_t numChannels, size_t numSamples) {
+    if (numChannels == 0) {
+        return;
+    }
+    if (hasDirtyBands_) {
+        updateCoefficients();
+    }
+    
+    // Each channel starts from the same point of any coefficient ramp
+    rampStart_.assign(coeffs_.begin(), coeffs_.end());
+    svfRampStart_.assign(svfCoeffs_.begin(), svfCoeffs_.end());
+    const size_t smoothingRemaining = smoothingRemaining_;
+    
+    // More channels than prepare() was told about allocate here
+    if (channelStates_.size() < numChannels - 1) {
+        channelStates_.resize(numChannels - 1);
+        channelSvfStates_.resize(numChannels - 1);
+    }
+    
+    process(channels[0], numSamples);
+    for (size_t ch = 1; ch < numChannels; ++ch) {
+        coeffs_.assign(rampStart_.begin(), rampStart_.end());
+        svfCoeffs_.assign(svfRampStart_.begin(), svfRampStart_.end());
+        smoothingRemaining_ = smoothingRemaining;
+        
+        // Bands added since this channel last ran start from rest
+        std::vector<BiquadState>& states = channelStates_[ch - 1];
+        std::vector<SvfState>& svfStates = channelSvfStates_[ch - 1];
+        states.resize(bands_.size());
+        svfStates.resize(bands_.size());
+        
+        states_.swap(states);
+        svfStates_.swap(svfStates);
+        process(channels[ch], numSamples);
+        states_.swap(states);
+        svfStates_.swap(svfStates);
     }
 }
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "dsp/biquad.h"
+#include "dsp/svf.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace audio_practice {
@@ -20,37 +24,109 @@ struct EQBand {
 
 class Equalizer {
 public:
+    enum class ProcessingMode {
+        Serial,        // fused per-sample cascade
+        BlockParallel  // several outputs per step, for long single channels
+    };
+    
+    enum class Topology {
+        Biquad,        // biquad cascade; supports both processing modes
+        StateVariable  // TPT state-variable filters, cheap to modulate per sample
+    };
+
     Equalizer();
     
-    // Add or update an EQ band
+    // Set the sample rate, largest block size and channel count before
+    // processing. Recomputes all bands through the shared coefficient cache,
+    // sizes per-channel state and clears filter state.
+    void prepare(float sampleRate, size_t maxBlockSize, size_t numChannels = 1);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Add or update an EQ band. Coefficients are recomputed lazily for the
+    // changed bands only, and ramp to their new values once audio is running.
+    // Only prepare(), setBands() and computeMagnitudeResponse() consult the
+    // process-wide coefficient cache; updates picked up by process() never
+    // lock or allocate.
     void setBand(size_t index, const EQBand& band);
     
+    // Replace every band from the control thread, resolving coefficients
+    // through the shared cache now so process() only ramps to them. The same
+    // band count ramps from the current response; otherwise filters restart.
+    void setBands(const std::vector<EQBand>& bands);
+    
     // Remove all bands
     void clearBands();
     
     // Process audio buffer in-place
     void process(float* data, size_t numSamples);
     
+    // Process several channels in-place with the same bands. Each channel
+    // keeps its own filter state and follows the same coefficient ramp.
+    void process(float* const* channels, size_t numChannels, size_t numSamples);
+    
+    // Clear filter state; pending parameter changes then apply without a ramp
+    void reset();
+    
+    // True when every filter state is below threshold, i.e. silent input
+    // would produce (near) silent output. Callers may then skip processing
+    // silence without cutting off a filter tail.
+    bool isQuiescent(float threshold = 1e-7f) const;
+    
+    // Length of the coefficient ramp after a parameter change (0 = jump)
+    void setSmoothingLength(size_t numSamples) { smoothingLength_ = numSamples; }
+    size_t getSmoothingLength() const { return smoothingLength_; }
+    
+    // Select the filter kernel; state carries over between modes
+    void setProcessingMode(ProcessingMode mode);
+    ProcessingMode getProcessingMode() const { return mode_; }
+    
+    // Select the filter structure; switching clears filter state
+    void setTopology(Topology topology);
+    Topology getTopology() const { return topology_; }
+    
     // Get current bands
     const std::vector<EQBand>& getBands() const { return bands_; }
+    
+    // Linear magnitude response of the whole cascade at arbitrary frequencies
+    // (Hz), evaluated with SIMD. Pending band changes are included.
+    void computeMagnitudeResponse(const float* frequencies, float* magnitudes, size_t count);
+
+    // Biquad coefficients for a single band (uncached)
+    static BiquadCoeffs calculateCoeffs(const EQBand& band, float sampleRate);
+    
+    // State-variable coefficients for a single band, same response as calculateCoeffs
+    static SvfCoeffs calculateSvfCoeffs(const EQBand& band, float sampleRate);
 
 private:
     std::vector<EQBand> bands_;
-    
-    struct BiquadCoeffs {
-        float a0, a1, a2, b1, b2;
-    };
-    
-    struct BiquadState {
-        float x1 = 0, x2 = 0;
-        float y1 = 0, y2 = 0;
-    };
-    
-    std::vector<BiquadCoeffs> coeffs_;
+    std::vector<BiquadCoeffs> coeffs_;        // what the kernels run with
+    std::vector<BiquadCoeffs> targetCoeffs_;  // where smoothing is heading
+    std::vector<BiquadCoeffs> coeffSteps_;    // per-sample ramp increment
     std::vector<BiquadState> states_;
+    std::vector<BiquadBlockCoeffs> blockCoeffs_;
+    std::vector<SvfCoeffs> svfCoeffs_;
+    std::vector<SvfCoeffs> svfTargets_;
+    std::vector<SvfCoeffs> svfSteps_;
+    std::vector<SvfState> svfStates_;
+    std::vector<std::vector<BiquadState>> channelStates_;  // channels after the first
+    std::vector<std::vector<SvfState>> channelSvfStates_;
+    std::vector<BiquadCoeffs> rampStart_;  // coefficients each channel starts from
+    std::vector<SvfCoeffs> svfRampStart_;
+    std::vector<uint8_t> dirty_;       // parameters changed since last update
+    std::vector<uint8_t> blockStale_;  // blockCoeffs_ entry needs rebuilding
+    bool hasDirtyBands_ = false;
+    bool active_ = false;              // audio has been processed since reset
+    size_t smoothingLength_ = 1024;
+    size_t smoothingRemaining_ = 0;
+    ProcessingMode mode_ = ProcessingMode::Serial;
+    Topology topology_ = Topology::Biquad;
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
     
-    void updateCoefficients(float sampleRate = 48000.0f);
-    BiquadCoeffs calculateCoeffs(const EQBand& band, float sampleRate);
+    void updateCoefficients(bool useCache = false);
+    void calculateCoeffsBatch(const size_t* indices, size_t count, bool cacheResults);
+    void refreshBlockCoeffs();
 };
 
 } // namespace audio_practice 
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "effects/gate.h"
+#include "core/silence_index.h"
+#include "dsp/simd_math.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace audio_practice {
+
+namespace {
+
+// Detector buffer length until prepare() says otherwise
+constexpr size_t kDefaultBlockSize = 512;
+
+// Fast detector ballistics so the gate opens on transients
+constexpr float kDetectorAttack = 0.1f;    // ms
+constexpr float kDetectorRelease = 10.0f;  // ms
+
+// Gain the open gate heads for, in log2 units
+constexpr float kOpenTarget = 1e-4f;
+
+// Gains within this many log2 units of the range floor count as closed (0.1 dB)
+constexpr float kFloorTolerance = 0.0166f;
+
+} // namespace
+
+Gate::Gate(const GateSettings& settings) : settings_(settings) {
+    envelope_.resize(kDefaultBlockSize);
+    link_.resize(kDefaultBlockSize);
+    updateCoefficients();
+    reset();
+}
+
+void Gate::prepare(float sampleRate, size_t maxBlockSize) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    envelope_.assign(maxBlockSize > 0 ? maxBlockSize : kDefaultBlockSize, 0.0f);
+    link_.assign(envelope_.size(), 0.0f);
+    closedBlocks_.reserve((envelope_.size() + kHintBlockSize - 1) / kHintBlockSize);
+    detector_.prepare(sampleRate, envelope_.size());
+    updateCoefficients();
+    reset();
+}
+
+void Gate::setSettings(const GateSettings& settings) {
+    settings_ = settings;
+    updateCoefficients();
+}
+
+void Gate::updateCoefficients() {
+    detector_.setSettings({settings_.detector, kDetectorAttack, kDetectorRelease, 10.0f});
+    
+    openLevel_ = std::pow(10.0f, settings_.threshold / 20.0f);
+    closeLevel_ = std::pow(10.0f, (settings_.threshold - settings_.hysteresis) / 20.0f);
+    thresholdLog2_ = std::log2(openLevel_);
+    rangeLog2_ = std::log2(std::pow(10.0f, settings_.range / 20.0f));
+    floorLog2_ = rangeLog2_ + kFloorTolerance;
+    
+    // The expansion curve reaches the range floor this far below the threshold
+    quietLevel_ = settings_.ratio > 1.0f
+        ? std::exp2(thresholdLog2_ + rangeLog2_ / (settings_.ratio - 1.0f)) : 0.0f;
+    
+    attackCoeff_ = std::exp(-1.0f / (settings_.attack * sampleRate_ / 1000.0f));
+    releaseCoeff_ = std::exp(-1.0f / (settings_.release * sampleRate_ / 1000.0f));
+    holdSamples_ = static_cast<size_t>(settings_.hold * sampleRate_ / 1000.0f);
+}
+
+void Gate::reset() {
+    detector_.reset();
+    open_ = false;
+    holdRemaining_ = 0;
+    gainLog2_ = rangeLog2_;
+    currentGainReduction_ = settings_.range;
+}
+
+bool Gate::staysClosed(float level) const {
+    return !open_ && gainLog2_ <= floorLog2_ &&
+           level <= quietLevel_ && detector_.getEnvelope() <= quietLevel_;
+}
+
+void Gate::computeGains(size_t offset, size_t numSamples) {
+    float* envelope = envelope_.data();
+    float* closedTargets = link_.data();
+    
+    // Gain while closed, from the expansion curve, 8 samples at a time
+    {
+        const __m256 threshold = _mm256_set1_ps(thresholdLog2_);
+        const __m256 expansion = _mm256_set1_ps(settings_.ratio - 1.0f);
+        const __m256 range = _mm256_set1_ps(rangeLog2_);
+        const __m256 minLevel = _mm256_set1_ps(1e-10f);
+        size_t i = 0;
+        for (; i + 8 <= numSamples; i += 8) {
+            __m256 levelLog2 = simd::log2_ps(_mm256_max_ps(_mm256_loadu_ps(&envelope[i]), minLevel));
+            __m256 target = _mm256_mul_ps(_mm256_sub_ps(levelLog2, threshold), expansion);
+            _mm256_storeu_ps(&closedTargets[i], _mm256_max_ps(target, range));
+        }
+        for (; i < numSamples; ++i) {
+            float levelLog2 = simd::log2_ss(std::max(envelope[i], 1e-10f));
+            closedTargets[i] = std::max((levelLog2 - thresholdLog2_) * (settings_.ratio - 1.0f), rangeLog2_);
+        }
+    }
+    
+    // Same min/max selection of attack or release as the envelope detector
+    const float attackCoeff = attackCoeff_;
+    const float releaseCoeff = releaseCoeff_;
+    const float attackInput = 1.0f - attackCoeff;
+    const float releaseInput = 1.0f - releaseCoeff;
+    const bool attackFaster = attackCoeff <= releaseCoeff;
+    const float openLevel = openLevel_;
+    const float closeLevel = closeLevel_;
+    const float floorLog2 = floorLog2_;
+    const size_t holdSamples = holdSamples_;
+    uint8_t* closedBlocks = closedBlocks_.data();
+    
+    bool open = open_;
+    size_t holdRemaining = holdRemaining_;
+    float gainLog2 = gainLog2_;
+    
+    for (size_t i = 0; i < numSamples; ++i) {
+        const float level = envelope[i];
+        
+        // Hysteresis: open above the threshold, close only once the level
+        // has stayed below the lower close threshold for the hold time
+        if (level >= openLevel) {
+            open = true;
+            holdRemaining = holdSamples;
+        } else if (level >= closeLevel) {
+            if (open) {
+                holdRemaining = holdSamples;
+            }
+        } else if (open) {
+            if (holdRemaining > 0) {
+                --holdRemaining;
+            } else {
+                open = false;
+            }
+        }
+        
+        // Smoothed in log2 units, so attack and release are dB rates. The
+        // open target sits just above unity so the gain never decays into
+        // denormals; the output is clamped to unity instead.
+        const float target = open ? kOpenTarget : closedTargets[i];
+        const float attacked = std::fma(attackCoeff, gainLog2, attackInput * target);
+        const float released = std::fma(releaseCoeff, gainLog2, releaseInput * target);
+        gainLog2 = attackFaster ? std::max(attacked, released) : std::min(attacked, released);
+        envelope[i] = std::min(gainLog2, 0.0f);
+        
+        if (gainLog2 > floorLog2) {
+            closedBlocks[(offset + i) / kHintBlockSize] = 0;
+        }
+    }
+    
+    open_ = open;
+    holdRemaining_ = holdRemaining;
+    gainLog2_ = gainLog2;
+    
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(&envelope[i], simd::exp2_ps(_mm256_loadu_ps(&envelope[i])));
+    }
+    for (; i < numSamples; ++i) {
+        envelope[i] = simd::exp2_ss(envelope[i]);
+    }
+}
+
+void Gate::process(float* data, size_t numSamples) {
+    process(&data, 1, numSamples);
+}
+
+void Gate::process(float* const* channels, size_t numChannels, size_t numSamples,
+                   const SilenceIndex* silence) {
+    closedBlocks_.assign((numSamples + kHintBlockSize - 1) / kHintBlockSize, 1);
+    if (numChannels == 0) {
+        return;
+    }
+    if (silence && (silence->getBlockSize() != kHintBlockSize ||
+                    silence->getNumSamples() != numSamples ||
+                    silence->getNumSilentBlocks() == 0)) {
+        silence = nullptr;
+    }
+    
+    for (size_t pos = 0; pos < numSamples;) {
+        size_t n = std::min(numSamples - pos, envelope_.size());
+        
+        if (silence && pos % kHintBlockSize == 0) {
+            const size_t block = pos / kHintBlockSize;
+            
+            // Nothing in a silent block can lift a gate resting at the
+            // floor, so its output is zero. The gain releases the rest of
+            // the way to the floor and the detector restarts from silence.
+            if (silence->isSilentBlock(block) && staysClosed(silence->getThreshold())) {
+                const size_t end = std::min(pos + kHintBlockSize, numSamples);
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    std::fill(channels[ch] + pos, channels[ch] + end, 0.0f);
+                }
+                gainLog2_ = rangeLog2_ + (gainLog2_ - rangeLog2_) *
+                            std::pow(releaseCoeff_, static_cast<float>(end - pos));
+                detector_.reset();
+                pos = end;
+                continue;
+            }
+            
+            // Stop at the next silent block so it can be skipped
+            for (size_t b = block + 1; b * kHintBlockSize < pos + n; ++b) {
+                if (silence->isSilentBlock(b)) {
+                    n = b * kHintBlockSize - pos;
+                    break;
+                }
+            }
+        }
+        
+        if (numChannels == 1) {
+            detector_.process(channels[0] + pos, envelope_.data(), n);
+        } else {
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+            float* link = link_.data();
+            std::fill(link, link + n, 0.0f);
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                const float* in = channels[ch] + pos;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 level = _mm256_and_ps(_mm256_loadu_ps(&in[i]), absMask);
+                    _mm256_storeu_ps(&link[i], _mm256_max_ps(_mm256_loadu_ps(&link[i]), level));
+                }
+                for (; i < n; ++i) {
+                    link[i] = std::max(link[i], std::abs(in[i]));
+                }
+            }
+            detector_.process(link, envelope_.data(), n);
+        }
+        
+        computeGains(pos, n);
+        
+        const float* gains = envelope_.data();
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            float* out = channels[ch] + pos;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_loadu_ps(&out[i]), _mm256_loadu_ps(&gains[i])));
+            }
+            for (; i < n; ++i) {
+                out[i] *= gains[i];
+            }
+        }
+        pos += n;
+    }
+    
+    if (numSamples > 0) {
+        currentGainReduction_ = std::min(gainLog2_, 0.0f) * kDbPerLog2;
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
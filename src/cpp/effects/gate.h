@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dsp/envelope_detector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace audio_practice {
+
+class SilenceIndex;
+
+struct GateSettings {
+    float threshold = -50.0f;   // dB, opens above
+    float hysteresis = 6.0f;    // dB below threshold where it closes again
+    float ratio = 10.0f;        // downward expansion while closed; large values gate hard
+    float range = -80.0f;       // dB, deepest attenuation
+    float attack = 1.0f;        // ms, opening
+    float hold = 50.0f;         // ms open after the level drops below the close threshold
+    float release = 100.0f;     // ms, closing
+    DetectorMode detector = DetectorMode::Peak;
+};
+
+// Noise gate / downward expander. An EnvelopeDetector drives an open/closed
+// state with hysteresis and hold; while closed, the gain follows the
+// expansion curve down to the range floor. Channels are linked.
+//
+// Each process() call also reports which kHintBlockSize-sample blocks sat at
+// the range floor throughout. Downstream stages can treat those blocks as
+// silence and skip them, dropping only audio that was already attenuated by
+// the full range.
+class Gate {
+public:
+    static constexpr size_t kHintBlockSize = 256;
+    
+    explicit Gate(const GateSettings& settings = {});
+    
+    // Set the sample rate and largest block size before processing.
+    // Recomputes time constants and clears all state.
+    void prepare(float sampleRate, size_t maxBlockSize);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    void reset();
+    
+    void setSettings(const GateSettings& settings);
+    const GateSettings& getSettings() const { return settings_; }
+    
+    // Process audio buffer in-place
+    void process(float* data, size_t numSamples);
+    
+    // Process several channels in-place with one linked detector. An
+    // optional silence index over the same samples, in kHintBlockSize
+    // blocks, lets the gate zero silent blocks it reaches already at the
+    // range floor without running the detector over them.
+    void process(float* const* channels, size_t numChannels, size_t numSamples,
+                 const SilenceIndex* silence = nullptr);
+    
+    // Skip hints for the last process() call: entry b is set when every
+    // sample of block b, counted from the start of that call, was at the
+    // range floor. The last block may be short.
+    const std::vector<uint8_t>& getClosedBlocks() const { return closedBlocks_; }
+    
+    bool isOpen() const { return open_; }
+    
+    // Current gain in dB (updated once per processed block)
+    float getGainReduction() const { return currentGainReduction_; }
+
+private:
+    GateSettings settings_;
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    
+    EnvelopeDetector detector_;
+    std::vector<float> envelope_;  // detector output, then gain, per sample
+    std::vector<float> link_;      // combined channel level, then closed-gate targets
+    std::vector<uint8_t> closedBlocks_;
+    
+    float openLevel_;
+    float closeLevel_;
+    float thresholdLog2_;
+    float rangeLog2_;
+    float floorLog2_;  // rangeLog2_ plus a small tolerance
+    float quietLevel_;  // levels up to this keep the closed gate at the range floor
+    float attackCoeff_;
+    float releaseCoeff_;
+    size_t holdSamples_;
+    
+    bool open_ = false;
+    size_t holdRemaining_ = 0;
+    float gainLog2_;
+    float currentGainReduction_ = 0.0f;
+    
+    void updateCoefficients();
+    
+    // True when a block no louder than level would leave the gate closed at
+    // the range floor throughout
+    bool staysClosed(float level) const;
+    
+    // envelope_ -> gain in place for samples [offset, offset + n) of the
+    // call, updating the closed-block hints
+    void computeGains(size_t offset, size_t numSamples);
+};
+
+} // namespace audio_practice
@@ -0,0 +1,148 @@
+#include "effects/limiter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace audio_practice {
+
+Limiter::Limiter(const LimiterSettings& settings)
+    : settings_(settings) {
+    // Windowed-sinc interpolators at 1/4, 2/4 and 3/4 of a sample, each
+    // normalized to unity DC gain
+    const double center = static_cast<double>(kTruePeakTaps) / 2.0 - 1.0;
+    for (size_t p = 0; p < kTruePeakPhases; ++p) {
+        const double offset = static_cast<double>(p + 1) / 4.0;
+        double sum = 0.0;
+        double taps[kTruePeakTaps];
+        for (size_t k = 0; k < kTruePeakTaps; ++k) {
+            double t = static_cast<double>(k) - center - offset;
+            double sinc = (t == 0.0) ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+            double window = 0.5 * (1.0 + std::cos(M_PI * t / (center + 1.0)));
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        for (size_t k = 0; k < kTruePeakTaps; ++k) {
+            truePeakTaps_[p][k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+    
+    configure();
+}
+
+void Limiter::prepare(float sampleRate, size_t maxBlockSize, size_t numChannels) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    numChannels_ = std::max<size_t>(1, numChannels);
+    configure();
+}
+
+void Limiter::setSettings(const LimiterSettings& settings) {
+    settings_ = settings;
+    configure();
+}
+
+void Limiter::configure() {
+    ceilingLinear_ = std::pow(10.0f, settings_.ceiling / 20.0f);
+    releaseCoeff_ = std::exp(-1.0f / (settings_.release * sampleRate_ / 1000.0f));
+    lookaheadSamples_ = std::max<size_t>(1, static_cast<size_t>(settings_.lookahead * sampleRate_ / 1000.0f));
+    
+    // The true-peak interpolators look half their length ahead
+    const size_t detectorDelay = settings_.truePeak ? kTruePeakTaps / 2 : 0;
+    latency_ = lookaheadSamples_ - 1 + detectorDelay;
+    
+    peakHold_.setWindow(lookaheadSamples_);
+    gainSmoother_.setWindow(lookaheadSamples_);
+    delay_.assign(numChannels_, std::vector<float>(latency_ + 1, 0.0f));
+    history_.assign(numChannels_, std::vector<float>(2 * kTruePeakTaps, 0.0f));
+    reset();
+}
+
+void Limiter::reset() {
+    peakHold_.reset();
+    gainSmoother_.reset();
+    
+    // The smoother averages gains, so it starts full of unity
+    for (size_t i = 0; i < lookaheadSamples_; ++i) {
+        gainSmoother_.push(1.0f);
+    }
+    releasedGain_ = 1.0f;
+    
+    for (auto& line : delay_) {
+        std::fill(line.begin(), line.end(), 0.0f);
+    }
+    for (auto& line : history_) {
+        std::fill(line.begin(), line.end(), 0.0f);
+    }
+    delayPos_ = 0;
+    historyPos_ = 0;
+    currentGainReduction_ = 0.0f;
+}
+
+float Limiter::truePeakLevel(const float* window) const {
+    // Sample at the interpolation center, then the points after it
+    float level = std::abs(window[kTruePeakTaps / 2 - 1]);
+    for (size_t p = 0; p < kTruePeakPhases; ++p) {
+        float y = 0.0f;
+        for (size_t k = 0; k < kTruePeakTaps; ++k) {
+            y += truePeakTaps_[p][k] * window[k];
+        }
+        level = std::max(level, std::abs(y));
+    }
+    return level;
+}
+
+void Limiter::process(float* data, size_t numSamples) {
+    float* channels[] = {data};
+    process(channels, 1, numSamples);
+}
+
+void Limiter::process(float* const* channels, size_t numChannels, size_t numSamples) {
+    if (numChannels > delay_.size()) {
+        numChannels_ = numChannels;
+        configure();
+    }
+    
+    const size_t delayLength = latency_ + 1;
+    const float ceiling = ceilingLinear_;
+    float minGain = 1.0f;
+    
+    for (size_t i = 0; i < numSamples; ++i) {
+        // Linked level across channels
+        float level = 0.0f;
+        if (settings_.truePeak) {
+            historyPos_ = (historyPos_ + 1 == kTruePeakTaps) ? 0 : historyPos_ + 1;
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                float* history = history_[ch].data();
+                history[historyPos_] = history[historyPos_ + kTruePeakTaps] = channels[ch][i];
+                level = std::max(level, truePeakLevel(history + historyPos_ + 1));
+            }
+        } else {
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                level = std::max(level, std::abs(channels[ch][i]));
+            }
+        }
+        
+        // Gain needed for the loudest sample in the lookahead window, released
+        // smoothly and ramped in over the window
+        float peak = peakHold_.push(level);
+        float target = (peak > ceiling) ? ceiling / peak : 1.0f;
+        releasedGain_ = (target < releasedGain_) ? target
+                                                 : target + (releasedGain_ - target) * releaseCoeff_;
+        float gain = static_cast<float>(gainSmoother_.push(releasedGain_) / lookaheadSamples_);
+        minGain = std::min(minGain, gain);
+        
+        // Delay and apply; the clamp only catches float rounding in the average
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            float* line = delay_[ch].data();
+            line[delayPos_] = channels[ch][i];
+            float delayed = line[(delayPos_ + 1 == delayLength) ? 0 : delayPos_ + 1];
+            channels[ch][i] = std::min(std::max(delayed * gain, -ceiling), ceiling);
+        }
+        delayPos_ = (delayPos_ + 1 == delayLength) ? 0 : delayPos_ + 1;
+    }
+    
+    if (numSamples > 0) {
+        currentGainReduction_ = 20.0f * std::log10(minGain);
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
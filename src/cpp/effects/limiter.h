@@ -0,0 +1,82 @@
+#pragma once
+
+#include "dsp/sliding_window.h"
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+struct LimiterSettings {
+    float ceiling = -1.0f;    // dBFS
+    float lookahead = 5.0f;   // ms
+    float release = 50.0f;    // ms
+    bool truePeak = false;    // limit 4x oversampled peaks instead of sample peaks
+};
+
+// Lookahead brickwall limiter. The audio is delayed by the lookahead while
+// the detector holds the window peak (sliding maximum) and ramps the gain
+// down over the same window (running-sum average), so the gain has reached
+// its target when the peak comes out. Release is a one-pole return to unity.
+// Channels are linked; output never exceeds the ceiling.
+class Limiter {
+public:
+    explicit Limiter(const LimiterSettings& settings = {});
+    
+    // Set the sample rate, largest block size and channel count before
+    // processing. Allocates delay lines and clears all state.
+    void prepare(float sampleRate, size_t maxBlockSize, size_t numChannels = 2);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Clear delay lines and detector
+    void reset();
+    
+    // Lookahead and ceiling changes reallocate and clear state
+    void setSettings(const LimiterSettings& settings);
+    const LimiterSettings& getSettings() const { return settings_; }
+    
+    // Process audio buffer in-place
+    void process(float* data, size_t numSamples);
+    
+    // Process several channels in-place with one linked gain. More channels
+    // than prepared reallocates.
+    void process(float* const* channels, size_t numChannels, size_t numSamples);
+    
+    // Delay from input to output, in samples
+    size_t getLatency() const { return latency_; }
+    
+    // Deepest gain reduction in the last processed block, in dB
+    float getGainReduction() const { return currentGainReduction_; }
+
+private:
+    LimiterSettings settings_;
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    size_t numChannels_ = 2;
+    
+    float ceilingLinear_;
+    float releaseCoeff_;
+    size_t lookaheadSamples_;
+    size_t latency_;
+    
+    SlidingMaximum peakHold_;
+    RunningSum gainSmoother_;
+    float releasedGain_ = 1.0f;
+    
+    std::vector<std::vector<float>> delay_;  // per channel, latency_ + 1 long
+    size_t delayPos_ = 0;
+    
+    // True-peak estimate: 3 interpolating phases between input samples
+    static constexpr size_t kTruePeakTaps = 12;
+    static constexpr size_t kTruePeakPhases = 3;
+    float truePeakTaps_[kTruePeakPhases][kTruePeakTaps];
+    std::vector<std::vector<float>> history_;  // per channel, doubled ring
+    size_t historyPos_ = 0;
+    
+    float currentGainReduction_ = 0.0f;
+    
+    void configure();
+    float truePeakLevel(const float* window) const;
+};
+
+} // namespace audio_practice
@@ -0,0 +1,221 @@
+#include "effects/multiband_compressor.h"
+#include "effects/equalizer.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <stdexcept>
+
+namespace audio_practice {
+
+namespace {
+
+// Band buffer length until prepare() says otherwise
+constexpr size_t kDefaultBlockSize = 512;
+
+constexpr float kButterworthQ = 0.70710678f;
+
+// Default crossovers per band count, spread roughly evenly in octaves
+const std::vector<float>& defaultCrossovers(size_t numBands) {
+    static const std::vector<float> kDefaults[] = {
+        {200.0f, 2000.0f},
+        {150.0f, 800.0f, 4000.0f},
+        {100.0f, 400.0f, 1600.0f, 6000.0f},
+    };
+    return kDefaults[numBands - MultibandCompressor::kMinBands];
+}
+
+// Second-order allpass with the Butterworth Q. Equals the sum of the LR4
+// lowpass and highpass at the same frequency, which is what a band that
+// bypasses a crossover must be delayed by.
+BiquadCoeffs allpassCoeffs(float frequency, float sampleRate) {
+    float omega = 2.0f * M_PI * frequency / sampleRate;
+    float cos_omega = std::cos(omega);
+    float alpha = std::sin(omega) / (2.0f * kButterworthQ);
+    float a0 = 1.0f + alpha;
+    
+    BiquadCoeffs coeffs;
+    coeffs.a0 = (1.0f - alpha) / a0;
+    coeffs.a1 = -2.0f * cos_omega / a0;
+    coeffs.a2 = 1.0f;
+    coeffs.b1 = coeffs.a1;
+    coeffs.b2 = coeffs.a0;
+    return coeffs;
+}
+
+} // namespace
+
+MultibandCompressor::MultibandCompressor(size_t numBands) {
+    setNumBands(numBands);
+}
+
+void MultibandCompressor::prepare(float sampleRate, size_t maxBlockSize, size_t numChannels) {
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    numChannels_ = numChannels;
+    configure();
+}
+
+void MultibandCompressor::setNumBands(size_t numBands) {
+    if (numBands < kMinBands || numBands > kMaxBands) {
+        throw std::invalid_argument("MultibandCompressor supports 3 to 5 bands");
+    }
+    crossovers_ = defaultCrossovers(numBands);
+    bandSettings_.assign(numBands, CompressorSettings{});
+    configure();
+}
+
+void MultibandCompressor::setCrossover(size_t index, float frequency) {
+    crossovers_[index] = frequency;
+    updateCrossovers();
+}
+
+void MultibandCompressor::setBandSettings(size_t band, const CompressorSettings& settings) {
+    bandSettings_[band] = settings;
+    for (size_t ch = 0; ch < numChannels_; ++ch) {
+        bank_.setSettings(ch * bandSettings_.size() + band, settings);
+    }
+}
+
+void MultibandCompressor::configure() {
+    const size_t numBands = bandSettings_.size();
+    const size_t numCrossovers = numBands - 1;
+    
+    lowCascades_.assign(numCrossovers, {});
+    highCascades_.assign(numCrossovers, {});
+    updateCrossovers();
+    
+    lowStates_.assign(numChannels_, std::vector<std::vector<BiquadState>>(numCrossovers));
+    highStates_.assign(numChannels_, std::vector<std::vector<BiquadState>>(numCrossovers));
+    for (size_t ch = 0; ch < numChannels_; ++ch) {
+        for (size_t k = 0; k < numCrossovers; ++k) {
+            lowStates_[ch][k].resize(lowCascades_[k].size());
+            highStates_[ch][k].resize(kCrossoverSections);
+        }
+    }
+    
+    const size_t numLanes = numChannels_ * numBands;
+    bank_.resize(numLanes);
+    for (size_t lane = 0; lane < numLanes; ++lane) {
+        bank_.setSettings(lane, bandSettings_[lane % numBands]);
+    }
+    bank_.prepare(sampleRate_, maxBlockSize_);
+    
+    const size_t blockSize = maxBlockSize_ > 0 ? maxBlockSize_ : kDefaultBlockSize;
+    bandBuffers_.assign(numLanes, std::vector<float>(blockSize, 0.0f));
+    lanePointers_.resize(numLanes);
+    for (size_t lane = 0; lane < numLanes; ++lane) {
+        lanePointers_[lane] = bandBuffers_[lane].data();
+    }
+}
+
+void MultibandCompressor::updateCrossovers() {
+    const size_t numCrossovers = crossovers_.size();
+    for (size_t k = 0; k < numCrossovers; ++k) {
+        EQBand band;
+        band.frequency = crossovers_[k];
+        band.q = kButterworthQ;
+        
+        band.type = EQBand::LOW_PASS;
+        const BiquadCoeffs lowpass = Equalizer::calculateCoeffs(band, sampleRate_);
+        band.type = EQBand::HIGH_PASS;
+        const BiquadCoeffs highpass = Equalizer::calculateCoeffs(band, sampleRate_);
+        
+        lowCascades_[k].assign(kCrossoverSections, makeBiquadBlockCoeffs(lowpass));
+        for (size_t j = k + 1; j < numCrossovers; ++j) {
+            lowCascades_[k].push_back(makeBiquadBlockCoeffs(allpassCoeffs(crossovers_[j], sampleRate_)));
+        }
+        highCascades_[k].assign(kCrossoverSections, makeBiquadBlockCoeffs(highpass));
+    }
+}
+
+void MultibandCompressor::reset() {
+    for (auto* states : {&lowStates_, &highStates_}) {
+        for (auto& channel : *states) {
+            for (auto& cascade : channel) {
+                std::fill(cascade.begin(), cascade.end(), BiquadState{});
+            }
+        }
+    }
+    bank_.reset();
+}
+
+float MultibandCompressor::getGainReduction(size_t band, size_t channel) const {
+    return bank_.getGainReduction(channel * bandSettings_.size() + band);
+}
+
+void MultibandCompressor::splitChannel(size_t channel, const float* input, size_t numSamples) {
+    const size_t numBands = bandSettings_.size();
+    float** bands = lanePointers_.data() + channel * numBands;
+    
+    // The top band buffer carries what is left above each crossover
+    float* remaining = bands[numBands - 1];
+    std::copy(input, input + numSamples, remaining);
+    
+    for (size_t k = 0; k + 1 < numBands; ++k) {
+        std::copy(remaining, remaining + numSamples, bands[k]);
+        processBiquadCascadeBlockParallel(lowCascades_[k].data(), lowStates_[channel][k].data(),
+                                          lowCascades_[k].size(), bands[k], numSamples);
+        processBiquadCascadeBlockParallel(highCascades_[k].data(), highStates_[channel][k].data(),
+                                          kCrossoverSections, remaining, numSamples);
+    }
+}
+
+void MultibandCompressor::process(float* data, size_t numSamples) {
+    process(&data, 1, numSamples);
+}
+
+void MultibandCompressor::process(float* const* channels, size_t numChannels, size_t numSamples) {
+    if (numChannels == 0 || numSamples == 0) {
+        return;
+    }
+    if (numChannels > numChannels_) {
+        numChannels_ = numChannels;
+        configure();
+    }
+    
+    const size_t numBands = bandSettings_.size();
+    const size_t blockSize = bandBuffers_.front().size();
+    
+    for (size_t pos = 0; pos < numSamples;) {
+        const size_t n = std::min(numSamples - pos, blockSize);
+        
+        for (size_t ch = 0; ch < numChannels_; ++ch) {
+            if (ch < numChannels) {
+                splitChannel(ch, channels[ch] + pos, n);
+            } else {
+                // Unused lanes see silence
+                for (size_t b = 0; b < numBands; ++b) {
+                    std::fill(lanePointers_[ch * numBands + b], lanePointers_[ch * numBands + b] + n, 0.0f);
+                }
+            }
+        }
+        
+        // All bands of all channels in one bank pass
+        bank_.process(lanePointers_.data(), n);
+        
+        // Recombine
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            float* const* bands = lanePointers_.data() + ch * numBands;
+            float* out = channels[ch] + pos;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 sum = _mm256_loadu_ps(&bands[0][i]);
+                for (size_t b = 1; b < numBands; ++b) {
+                    sum = _mm256_add_ps(sum, _mm256_loadu_ps(&bands[b][i]));
+                }
+                _mm256_storeu_ps(&out[i], sum);
+            }
+            for (; i < n; ++i) {
+                float sum = bands[0][i];
+                for (size_t b = 1; b < numBands; ++b) {
+                    sum += bands[b][i];
+                }
+                out[i] = sum;
+            }
+        }
+        
+        pos += n;
+    }
+}
+
+} // namespace audio_practice 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "dsp/biquad.h"
+#include "effects/compressor.h"
+#include "effects/compressor_bank.h"
+#include <cstddef>
+#include <vector>
+
+namespace audio_practice {
+
+// Multiband compressor for bus and mastering use. A tree of 4th-order
+// Linkwitz-Riley crossovers (two Butterworth biquads per side) splits the
+// signal into bands; each lower band also runs through the allpasses of the
+// crossovers above it, so the bands sum back to an allpass-filtered copy of
+// the input with a flat magnitude. Every band of every channel is one lane of
+// a CompressorBank, so all bands are compressed together in SIMD, and the
+// bands are summed in a single pass. Channels are compressed independently.
+class MultibandCompressor {
+public:
+    static constexpr size_t kMinBands = 3;
+    static constexpr size_t kMaxBands = 5;
+    
+    // Throws std::invalid_argument outside [kMinBands, kMaxBands]
+    explicit MultibandCompressor(size_t numBands = 3);
+    
+    // Set the sample rate, largest block size and channel count before
+    // processing. Recomputes crossovers and clears all state.
+    void prepare(float sampleRate, size_t maxBlockSize, size_t numChannels = 2);
+    float getSampleRate() const { return sampleRate_; }
+    size_t getMaxBlockSize() const { return maxBlockSize_; }
+    
+    // Changing the band count restores default crossovers and band settings;
+    // throws std::invalid_argument outside [kMinBands, kMaxBands]
+    void setNumBands(size_t numBands);
+    size_t getNumBands() const { return bandSettings_.size(); }
+    
+    // Crossover index i splits band i from band i + 1 (Hz, ascending)
+    void setCrossover(size_t index, float frequency);
+    float getCrossover(size_t index) const { return crossovers_[index]; }
+    
+    void setBandSettings(size_t band, const CompressorSettings& settings);
+    const CompressorSettings& getBandSettings(size_t band) const { return bandSettings_[band]; }
+    
+    // Clear filter state and envelopes
+    void reset();
+    
+    // Process audio buffer in-place
+    void process(float* data, size_t numSamples);
+    
+    // Process several channels in-place. More channels than prepared
+    // reallocates.
+    void process(float* const* channels, size_t numChannels, size_t numSamples);
+    
+    // Gain reduction of one band in dB (updated once per processed block)
+    float getGainReduction(size_t band, size_t channel = 0) const;
+
+private:
+    // Sections per crossover side: LR4 = two cascaded Butterworth biquads
+    static constexpr size_t kCrossoverSections = 2;
+    
+    std::vector<float> crossovers_;
+    std::vector<CompressorSettings> bandSettings_;
+    float sampleRate_ = 48000.0f;
+    size_t maxBlockSize_ = 0;
+    size_t numChannels_ = 2;
+    
+    // lowCascades_[k]: lowpass of crossover k followed by the allpasses of
+    // crossovers k + 1 and up; highCascades_[k]: highpass of crossover k.
+    // Block-parallel form, since each channel is one long serial chain.
+    std::vector<std::vector<BiquadBlockCoeffs>> lowCascades_;
+    std::vector<std::vector<BiquadBlockCoeffs>> highCascades_;
+    // Per channel, same shapes as the cascades
+    std::vector<std::vector<std::vector<BiquadState>>> lowStates_;
+    std::vector<std::vector<std::vector<BiquadState>>> highStates_;
+    
+    CompressorBank bank_;  // lane = channel * numBands + band
+    std::vector<std::vector<float>> bandBuffers_;  // one per lane
+    std::vector<float*> lanePointers_;
+    
+    void configure();
+    void updateCrossovers();
+    void splitChannel(size_t channel, const float* input, size_t numSamples);
+};
+
+} // namespace audio_practice
@@ -6,8 +6,9 @@ A professional-grade audio processing library combining C++ performance with Pyt
 from .interface.audio_file import AudioFile
 from .interface.auto_mixer import AutoMixer
 from .interface.realtime_mixer import RealtimeMixer
+from .interface.streaming_mixer import StreamingMixer
 from .automixer.pedalboard_processor import PedalboardProcessor
 
 __version__ = "1.0.0"
 __author__ = "tuanluongworks"
-__all__ = ["AudioFile", "AutoMixer", "RealtimeMixer", "PedalboardProcessor"] 
\ No newline at end of file
+__all__ = ["AudioFile", "AutoMixer", "RealtimeMixer", "StreamingMixer", "PedalboardProcessor"] 
\ No newline at end of file
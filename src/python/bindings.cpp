@@ -2,84 +2,560 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include "core/audio_buffer.h"
+#include "core/sample_conversion.h"
+#include "core/shared_memory.h"
 #include "dsp/auto_mixer.h"
 #include "effects/compressor.h"
 #include "effects/equalizer.h"
+#include "dsp/spectrum_analyzer.h"
+#include "dsp/streaming_mixer.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <unistd.h>
 
 namespace py = pybind11;
 using namespace audio_practice;
 
-// Convert numpy array to AudioBuffer
-AudioBuffer numpy_to_buffer(py::array_t<float> input) {
-    auto buf = input.request();
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// Capsules carrying an AudioBuffer's storage handle into numpy
+constexpr const char* kStorageCapsule = "audio_practice.AudioBuffer.storage";
+
+// Storage handle keeping a Python object alive; the reference is dropped
+// under the GIL whichever thread releases the last buffer
+std::shared_ptr<void> keep_alive(py::object object) {
+    return std::shared_ptr<void>(new py::object(std::move(object)), [](void* ptr) {
+        py::gil_scoped_acquire gil;
+        delete static_cast<py::object*>(ptr);
+    });
+}
+
+// Wrap a float32 C-contiguous array (channels x samples, or 1-D mono)
+// without copying. Arrays created by buffer_to_numpy hand back the original
+// storage handle; other arrays are borrowed. Other dtypes and layouts go
+// through to_buffer.
+AudioBuffer wrap_array(const FloatArray& input) {
+    if (input.ndim() != 1 && input.ndim() != 2) {
+        throw std::runtime_error("Input should be 2-D (channels x samples) or 1-D (mono)");
+    }
+    
+    size_t channels = input.ndim() == 2 ? input.shape(0) : 1;
+    size_t samples = input.ndim() == 2 ? input.shape(1) : input.shape(0);
+    float* ptr = const_cast<float*>(input.data());
     
-    if (buf.ndim != 2) {
-        throw std::runtime_error("Input should be 2-D (channels x samples)");
+    py::object base = input.base();
+    if (base && py::isinstance<py::capsule>(base)) {
+        auto capsule = py::reinterpret_borrow<py::capsule>(base);
+        const char* name = capsule.name();
+        if (name && std::strcmp(name, kStorageCapsule) == 0) {
+            return AudioBuffer(ptr, channels, samples,
+                               *capsule.get_pointer<std::shared_ptr<void>>());
+        }
+    }
+    return AudioBuffer(ptr, channels, samples, keep_alive(input));
+}
+
+// Sample formats with a SIMD conversion path (native byte order only)
+bool sample_format(const py::array& array, SampleFormat& format) {
+    if (py::isinstance<py::array_t<float>>(array)) {
+        format = SampleFormat::Float32;
+    } else if (py::isinstance<py::array_t<double>>(array)) {
+        format = SampleFormat::Float64;
+    } else if (py::isinstance<py::array_t<int16_t>>(array)) {
+        format = SampleFormat::Int16;
+    } else if (py::isinstance<py::array_t<int32_t>>(array)) {
+        format = SampleFormat::Int32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// How an array's samples are laid out in memory
+struct ArrayLayout {
+    size_t channels = 1;
+    size_t frames = 0;
+    int channelAxis = 0;
+    bool interleaved = false;  // frame after frame rather than channel after channel
+};
+
+// Layout of a 1-D (mono) or 2-D array whose channels run along channelAxis;
+// -1 takes the shorter axis, so samples x channels input works unannotated.
+// C-order channels x samples and Fortran-order samples x channels arrays are
+// planar, their transposes interleaved. Returns false for other strides.
+bool describe_layout(const py::array& array, int channelAxis, ArrayLayout& layout) {
+    if (array.ndim() != 1 && array.ndim() != 2) {
+        throw std::runtime_error("Input should be 2-D (channels x samples) or 1-D (mono)");
     }
     
-    size_t channels = buf.shape[0];
-    size_t samples = buf.shape[1];
+    const py::ssize_t itemSize = array.itemsize();
+    if (array.ndim() == 1) {
+        layout.channels = 1;
+        layout.frames = array.shape(0);
+        layout.channelAxis = 0;
+        layout.interleaved = false;
+        return layout.frames <= 1 || array.strides(0) == itemSize;
+    }
     
-    AudioBuffer buffer(channels, samples);
-    float* ptr = static_cast<float*>(buf.ptr);
+    if (channelAxis < 0) {
+        channelAxis = array.shape(0) > array.shape(1) ? 1 : 0;
+    }
+    layout.channelAxis = channelAxis;
+    layout.channels = array.shape(channelAxis);
+    layout.frames = array.shape(1 - channelAxis);
+    const py::ssize_t channelStride = array.strides(channelAxis);
+    const py::ssize_t frameStride = array.strides(1 - channelAxis);
     
-    for (size_t ch = 0; ch < channels; ++ch) {
-        float* channelData = buffer.getChannelData(ch);
-        for (size_t i = 0; i < samples; ++i) {
-            channelData[i] = ptr[ch * samples + i];
+    // Strides of length-1 axes carry no information
+    auto fits = [](py::ssize_t stride, py::ssize_t expected, size_t extent) {
+        return extent <= 1 || stride == expected;
+    };
+    const py::ssize_t frames = static_cast<py::ssize_t>(layout.frames);
+    const py::ssize_t channels = static_cast<py::ssize_t>(layout.channels);
+    if (fits(frameStride, itemSize, layout.frames) &&
+        fits(channelStride, itemSize * frames, layout.channels)) {
+        layout.interleaved = false;
+        return true;
+    }
+    if (fits(channelStride, itemSize, layout.channels) &&
+        fits(frameStride, itemSize * channels, layout.frames)) {
+        layout.interleaved = true;
+        return true;
+    }
+    return false;
+}
+
+// Integer PCM without a SIMD kernel (8-bit, unsigned, 64-bit) as float64
+// with the same full-scale mapping; unsigned PCM is offset binary
+py::array scale_integer_pcm(const py::array& array) {
+    const int bits = 8 * static_cast<int>(array.itemsize());
+    const double offset = array.dtype().kind() == 'u' ? std::ldexp(1.0, bits - 1) : 0.0;
+    py::object wide = array.attr("astype")(py::dtype::of<double>());
+    return py::array::ensure((wide - py::float_(offset)) * py::float_(std::ldexp(1.0, 1 - bits)));
+}
+
+// Array with a known sample format and layout. Byte-swapped arrays are
+// swapped to native order and strided views copied in their own dtype, so
+// PCM keeps its scaling; other integer widths are scaled here and other
+// float types cast to float32.
+py::array prepare_array(py::handle object, int channelAxis, SampleFormat& format,
+                        ArrayLayout& layout) {
+    py::array array = py::array::ensure(object);
+    if (!array) {
+        throw py::type_error("Expected a numpy array");
+    }
+    if (!array.dtype().attr("isnative").cast<bool>()) {
+        array = py::array::ensure(array.attr("astype")(array.dtype().attr("newbyteorder")("=")));
+    }
+    
+    const char kind = array.dtype().kind();
+    if ((kind == 'i' || kind == 'u') && !sample_format(array, format)) {
+        array = scale_integer_pcm(array);
+    }
+    if (!sample_format(array, format)) {
+        if (kind != 'f') {
+            throw py::type_error("Unsupported sample dtype " +
+                                 py::str(array.dtype()).cast<std::string>());
+        }
+        array = FloatArray::ensure(array);
+        if (!array) {
+            throw py::type_error("Array cannot be converted to float32");
         }
+        format = SampleFormat::Float32;
+    }
+    
+    if (!describe_layout(array, channelAxis, layout)) {
+        array = py::array::ensure(array, py::array::c_style);
+        describe_layout(array, channelAxis, layout);
+    }
+    return array;
+}
+
+// Convert a prepared array into a buffer of the same shape
+void convert_into(const py::array& array, SampleFormat format, const ArrayLayout& layout,
+                  AudioBuffer& buffer) {
+    std::vector<float*> channels(layout.channels);
+    for (size_t ch = 0; ch < layout.channels; ++ch) {
+        channels[ch] = buffer.getChannelData(ch);
     }
+    const void* source = array.data();
+    {
+        py::gil_scoped_release release;
+        convertToPlanar(source, format, layout.channels, layout.frames,
+                        layout.interleaved, channels.data());
+    }
+}
+
+// Read any 1-D or 2-D array into an AudioBuffer. float32 channels x samples
+// arrays are wrapped without copying (unless the buffer must be writable and
+// the array is read-only); float64, int16 and int32 arrays and interleaved
+// or Fortran-order layouts are converted by SIMD kernels straight into the
+// buffer's storage, in one pass and without the GIL.
+AudioBuffer to_buffer(py::handle object, int channelAxis = -1, bool writable = false) {
+    SampleFormat format;
+    ArrayLayout layout;
+    py::array array = prepare_array(object, channelAxis, format, layout);
     
+    if (format == SampleFormat::Float32 && !layout.interleaved && layout.channelAxis == 0 &&
+        (!writable || array.writeable())) {
+        return wrap_array(py::reinterpret_borrow<FloatArray>(array));
+    }
+    
+    AudioBuffer buffer(layout.channels, layout.frames);
+    convert_into(array, format, layout, buffer);
     return buffer;
 }
 
-// Convert AudioBuffer to numpy array
+// Convert numpy array to AudioBuffer, sharing the array's memory when it is
+// float32 channels x samples. Read-only arrays are copied since the buffer
+// can be written through.
+AudioBuffer numpy_to_buffer(const py::object& input, std::optional<bool> channelsFirst) {
+    int channelAxis = -1;
+    if (channelsFirst) {
+        channelAxis = *channelsFirst ? 0 : 1;
+    }
+    return to_buffer(input, channelAxis, true);
+}
+
+// Segment name unique across processes, for shared buffers created without one
+std::string unique_shared_name() {
+    static std::atomic<unsigned> counter{0};
+    static const unsigned salt = std::random_device()();
+    char name[64];
+    std::snprintf(name, sizeof(name), "/audio_practice_%d_%x_%u",
+                  static_cast<int>(getpid()), salt, counter++);
+    return name;
+}
+
+// Shared buffers pickle as their segment name plus a reference that the
+// unpickling process takes over, so the name outlives the sender; private
+// buffers pickle their samples.
+py::tuple pickle_buffer(const AudioBuffer& buffer) {
+    if (auto segment = getSharedSegment(buffer)) {
+        segment->retain();
+        return py::make_tuple(segment->getName());
+    }
+    return py::make_tuple(buffer.getNumChannels(), buffer.getNumSamples(),
+                          py::bytes(reinterpret_cast<const char*>(buffer.getData()),
+                                    buffer.getNumChannels() * buffer.getNumSamples() * sizeof(float)));
+}
+
+AudioBuffer unpickle_buffer(const py::tuple& state) {
+    if (state.size() == 1) {
+        return adoptSharedAudioBuffer(state[0].cast<std::string>());
+    }
+    if (state.size() != 3) {
+        throw std::runtime_error("Invalid AudioBuffer state");
+    }
+    
+    AudioBuffer buffer(state[0].cast<size_t>(), state[1].cast<size_t>());
+    std::string samples = state[2].cast<std::string>();
+    if (samples.size() != buffer.getNumChannels() * buffer.getNumSamples() * sizeof(float)) {
+        throw std::runtime_error("Invalid AudioBuffer state");
+    }
+    std::memcpy(buffer.getData(), samples.data(), samples.size());
+    return buffer;
+}
+
+// Convert AudioBuffer to numpy array viewing the same memory
 py::array_t<float> buffer_to_numpy(const AudioBuffer& buffer) {
     size_t channels = buffer.getNumChannels();
     size_t samples = buffer.getNumSamples();
+    std::vector<size_t> shape = {channels, samples};
     
-    py::array_t<float> result({channels, samples});
-    auto buf = result.request();
-    float* ptr = static_cast<float*>(buf.ptr);
+    if (!buffer.getOwner()) {
+        return py::array_t<float>(shape, buffer.getData());
+    }
     
-    for (size_t ch = 0; ch < channels; ++ch) {
-        const float* channelData = buffer.getChannelData(ch);
-        for (size_t i = 0; i < samples; ++i) {
-            ptr[ch * samples + i] = channelData[i];
+    py::capsule storage(new std::shared_ptr<void>(buffer.getOwner()), kStorageCapsule,
+                        [](PyObject* capsule) {
+        delete static_cast<std::shared_ptr<void>*>(PyCapsule_GetPointer(capsule, kStorageCapsule));
+    });
+    return py::array_t<float>(shape, const_cast<float*>(buffer.getData()), storage);
+}
+
+// Tracks may be AudioBuffers or arrays; AudioBuffers and float32 arrays
+// are read in place, other arrays converted once
+std::vector<AudioBuffer> to_tracks(const py::sequence& tracks) {
+    std::vector<AudioBuffer> buffers;
+    buffers.reserve(tracks.size());
+    for (py::handle track : tracks) {
+        if (py::isinstance<AudioBuffer>(track)) {
+            auto& buffer = track.cast<AudioBuffer&>();
+            std::shared_ptr<void> owner = buffer.getOwner()
+                ? buffer.getOwner() : keep_alive(py::reinterpret_borrow<py::object>(track));
+            buffers.emplace_back(buffer.getData(), buffer.getNumChannels(),
+                                 buffer.getNumSamples(), std::move(owner));
+        } else {
+            buffers.push_back(to_buffer(track));
         }
     }
+    return buffers;
+}
+
+// Channel pointers into an array that is processed in place. Only writable
+// float32 C-contiguous arrays qualify: a converted copy would leave the
+// caller's array untouched.
+std::vector<float*> in_place_channels(const py::array& array, size_t& numSamples) {
+    if (!py::isinstance<py::array_t<float, py::array::c_style>>(array)) {
+        throw py::type_error("In-place processing needs a C-contiguous float32 array");
+    }
+    if (!array.writeable()) {
+        throw std::runtime_error("In-place processing needs a writable array");
+    }
+    if (array.ndim() != 1 && array.ndim() != 2) {
+        throw std::runtime_error("Input should be 2-D (channels x samples) or 1-D (mono)");
+    }
+    
+    size_t channels = array.ndim() == 2 ? array.shape(0) : 1;
+    numSamples = array.ndim() == 2 ? array.shape(1) : array.shape(0);
+    float* data = static_cast<float*>(const_cast<void*>(array.data()));
     
-    return result;
+    std::vector<float*> pointers(channels);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        pointers[ch] = data + ch * numSamples;
+    }
+    return pointers;
 }
 
+// StreamingMixer with everything a block needs preallocated: the output
+// buffer (shared with numpy), per-track scratch for blocks that need
+// conversion, channel pointer tables and references to the input arrays for
+// the duration of the call
+struct PyStreamingMixer {
+    PyStreamingMixer(const AutoMixerSettings& settings, const std::vector<size_t>& trackChannels,
+                     size_t blockSize)
+        : mixer(settings, trackChannels, blockSize),
+          output(2, mixer.getMaxBlockSize()),
+          outputArray(buffer_to_numpy(output)) {
+        size_t totalChannels = 0;
+        scratch.reserve(trackChannels.size());
+        for (size_t channels : trackChannels) {
+            totalChannels += channels;
+            scratch.emplace_back(channels, mixer.getMaxBlockSize());
+            std::vector<float*>& pointers = scratchChannels.emplace_back(channels);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                pointers[ch] = scratch.back().getChannelData(ch);
+            }
+        }
+        channels.resize(totalChannels);
+        tracks.resize(trackChannels.size());
+        inputs.reserve(trackChannels.size());
+    }
+    
+    StreamingMixer mixer;
+    AudioBuffer output;
+    py::array outputArray;
+    std::vector<AudioBuffer> scratch;
+    std::vector<std::vector<float*>> scratchChannels;
+    std::vector<const float*> channels;
+    std::vector<const float* const*> tracks;
+    std::vector<py::object> inputs;
+    
+    // Mix one block per track; returns a view of the first numSamples output
+    // samples, valid until the next call. float32 planar blocks are read in
+    // place, anything else is converted into the track's scratch buffer.
+    py::array process(const py::sequence& blocks) {
+        if (blocks.size() != tracks.size()) {
+            throw std::runtime_error("Expected one block per track");
+        }
+        
+        inputs.clear();
+        size_t numSamples = 0;
+        size_t next = 0;
+        for (size_t t = 0; t < tracks.size(); ++t) {
+            const size_t numChannels = mixer.getTrackChannels(t);
+            py::array block = py::array::ensure(blocks[t]);
+            if (!block) {
+                throw py::type_error("Expected a numpy array per track");
+            }
+            
+            // Blocks may be channels x samples or samples x channels
+            int channelAxis = 0;
+            if (block.ndim() == 2 && static_cast<size_t>(block.shape(0)) != numChannels &&
+                static_cast<size_t>(block.shape(1)) == numChannels) {
+                channelAxis = 1;
+            }
+            
+            SampleFormat format;
+            ArrayLayout layout;
+            block = prepare_array(block, channelAxis, format, layout);
+            if (layout.channels != numChannels) {
+                throw std::runtime_error("Block shape does not match the track's channel count");
+            }
+            if (t > 0 && layout.frames != numSamples) {
+                throw std::runtime_error("All blocks must have the same length");
+            }
+            if (layout.frames > mixer.getMaxBlockSize()) {
+                throw std::runtime_error("Block is longer than the mixer's block size");
+            }
+            numSamples = layout.frames;
+            
+            tracks[t] = channels.data() + next;
+            if (format == SampleFormat::Float32 && !layout.interleaved) {
+                const float* data = static_cast<const float*>(block.data());
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    channels[next++] = data + ch * numSamples;
+                }
+                inputs.push_back(std::move(block));
+            } else {
+                convertToPlanar(block.data(), format, numChannels, numSamples,
+                                layout.interleaved, scratchChannels[t].data());
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    channels[next++] = scratchChannels[t][ch];
+                }
+            }
+        }
+        
+        {
+            py::gil_scoped_release release;
+            float* out[2] = {output.getChannelData(0), output.getChannelData(1)};
+            mixer.process(tracks.data(), out, numSamples);
+        }
+        inputs.clear();
+        
+        return py::array(py::dtype::of<float>(),
+                         std::vector<py::ssize_t>{2, static_cast<py::ssize_t>(numSamples)},
+                         std::vector<py::ssize_t>{
+                             static_cast<py::ssize_t>(output.getNumSamples() * sizeof(float)),
+                             static_cast<py::ssize_t>(sizeof(float))},
+                         output.getData(), outputArray);
+    }
+};
+
 PYBIND11_MODULE(audio_practice_native, m) {
     m.doc() = "Audio Practice - C++ Audio Processing Library";
 
+    // Every processing call below releases the GIL. Bound objects are not
+    // internally synchronized: share one between threads only for reads, and
+    // give each thread its own mixer or effect instance.
+
     // AudioBuffer
-    py::class_<AudioBuffer>(m, "AudioBuffer")
+    py::class_<AudioBuffer>(m, "AudioBuffer", py::buffer_protocol(),
+        "Planar float32 audio. Methods release the GIL; concurrent writers to "
+        "the same buffer (or the array it wraps) must be serialized by the caller. "
+        "Shared buffers (create_shared, share) live in POSIX shared memory and pickle "
+        "as a handle; the same rule then applies across processes.")
         .def(py::init<size_t, size_t>())
-        .def("apply_gain", &AudioBuffer::applyGain)
-        .def("clear", &AudioBuffer::clear)
+        .def(py::init(&numpy_to_buffer), py::arg("array"), py::arg("channels_first") = py::none(),
+             "Wrap a float32 channels x samples array without copying. float64, int16 and "
+             "int32 arrays, 1-D mono and samples x channels (interleaved) or Fortran-order "
+             "layouts are converted in one pass; other integer PCM is scaled to +-1. The channel axis is the shorter one unless "
+             "channels_first is given.")
+        .def_buffer([](AudioBuffer& buffer) {
+            return py::buffer_info(
+                buffer.getData(), sizeof(float), py::format_descriptor<float>::format(), 2,
+                {buffer.getNumChannels(), buffer.getNumSamples()},
+                {buffer.getNumSamples() * sizeof(float), sizeof(float)});
+        })
+        .def("apply_gain", &AudioBuffer::applyGain,
+             py::call_guard<py::gil_scoped_release>())
+        .def("clear", &AudioBuffer::clear, py::call_guard<py::gil_scoped_release>())
         .def("get_num_channels", &AudioBuffer::getNumChannels)
         .def("get_num_samples", &AudioBuffer::getNumSamples)
-        .def("add_from", &AudioBuffer::addFrom, py::arg("other"), py::arg("gain") = 1.0f);
+        .def("add_from", &AudioBuffer::addFrom, py::arg("other"), py::arg("gain") = 1.0f,
+             py::call_guard<py::gil_scoped_release>())
+        .def_static("create_shared", [](size_t channels, size_t samples,
+                                        std::optional<std::string> name) {
+            return createSharedAudioBuffer(name ? *name : unique_shared_name(), channels, samples);
+        }, py::arg("channels"), py::arg("samples"), py::arg("name") = py::none(),
+           "Zeroed buffer in a named POSIX shared-memory segment. It pickles as the "
+           "segment name, so multiprocessing workers map the same samples instead of "
+           "receiving a copy. The name is released when no process holds a buffer or "
+           "an unread pickle of it.")
+        .def_static("share", [](const py::object& array, std::optional<bool> channelsFirst,
+                                std::optional<std::string> name) {
+            int channelAxis = -1;
+            if (channelsFirst) {
+                channelAxis = *channelsFirst ? 0 : 1;
+            }
+            SampleFormat format;
+            ArrayLayout layout;
+            py::array prepared = prepare_array(array, channelAxis, format, layout);
+            AudioBuffer buffer = createSharedAudioBuffer(name ? *name : unique_shared_name(),
+                                                         layout.channels, layout.frames);
+            convert_into(prepared, format, layout, buffer);
+            return buffer;
+        }, py::arg("array"), py::arg("channels_first") = py::none(), py::arg("name") = py::none(),
+           "Copy an array (any dtype or layout accepted by AudioBuffer) into a new "
+           "shared-memory buffer")
+        .def_static("open_shared", &openSharedAudioBuffer, py::arg("name"),
+                    "Map a shared buffer created by another process")
+        .def_property_readonly("shared_name", [](const AudioBuffer& buffer) -> py::object {
+            auto segment = getSharedSegment(buffer);
+            if (!segment) {
+                return py::none();
+            }
+            return py::str(segment->getName());
+        })
+        .def("unlink_shared", [](const AudioBuffer& buffer) {
+            auto segment = getSharedSegment(buffer);
+            if (!segment) {
+                throw std::runtime_error("AudioBuffer is not shared");
+            }
+            segment->unlink();
+        }, "Release the segment name now, e.g. after pickles that will never be loaded. "
+           "Existing mappings stay valid.")
+        .def(py::pickle(&pickle_buffer, &unpickle_buffer));
 
     // AutoMixerSettings
     py::class_<AutoMixerSettings>(m, "AutoMixerSettings")
         .def(py::init<>())
+        .def_readwrite("sample_rate", &AutoMixerSettings::sampleRate)
         .def_readwrite("target_lufs", &AutoMixerSettings::targetLUFS)
         .def_readwrite("max_gain_reduction", &AutoMixerSettings::maxGainReduction)
         .def_readwrite("frequency_separation", &AutoMixerSettings::frequencySeparation)
         .def_readwrite("enable_dynamic_eq", &AutoMixerSettings::enableDynamicEQ)
         .def_readwrite("enable_spatial_processing", &AutoMixerSettings::enableSpatialProcessing)
         .def_readwrite("mix_bus_comp_ratio", &AutoMixerSettings::mixBusCompRatio)
-        .def_readwrite("mix_bus_comp_threshold", &AutoMixerSettings::mixBusCompThreshold);
+        .def_readwrite("mix_bus_comp_threshold", &AutoMixerSettings::mixBusCompThreshold)
+        .def_readwrite("mix_bus_ceiling", &AutoMixerSettings::mixBusCeiling)
+        .def_readwrite("voice_tracks", &AutoMixerSettings::voiceTracks)
+        .def_readwrite("enable_ducking", &AutoMixerSettings::enableDucking)
+        .def_readwrite("ducking_threshold", &AutoMixerSettings::duckingThreshold)
+        .def_readwrite("ducking_ratio", &AutoMixerSettings::duckingRatio)
+        .def_readwrite("ducking_lookahead", &AutoMixerSettings::duckingLookahead)
+        .def_readwrite("enable_gate", &AutoMixerSettings::enableGate)
+        .def_readwrite("gate_threshold", &AutoMixerSettings::gateThreshold);
 
     // AutoMixer
-    py::class_<AutoMixer>(m, "AutoMixer")
+    py::class_<AutoMixer>(m, "AutoMixer",
+        "Keeps per-track processors between calls, so an instance must not be used "
+        "from two threads at once. Separate instances mix in parallel.")
         .def(py::init<const AutoMixerSettings&>(), py::arg("settings") = AutoMixerSettings())
-        .def("process", &AutoMixer::process)
-        .def("analyze_tracks", &AutoMixer::analyzeTracks);
+        .def("process", [](AutoMixer& mixer, const py::sequence& tracks) {
+            std::vector<AudioBuffer> buffers = to_tracks(tracks);
+            AudioBuffer mix(2, 0);
+            {
+                py::gil_scoped_release release;
+                mix = mixer.process(buffers);
+            }
+            return buffer_to_numpy(mix);
+        }, py::arg("tracks"), "Mix arrays or AudioBuffers; returns a 2 x samples float32 array")
+        .def("analyze_tracks", [](AutoMixer& mixer, const py::sequence& tracks) {
+            std::vector<AudioBuffer> buffers = to_tracks(tracks);
+            py::gil_scoped_release release;
+            return mixer.analyzeTracks(buffers);
+        }, py::arg("tracks"));
+
+    // Result of analyze_tracks
+    py::class_<AutoMixer::MixParameters>(m, "MixParameters")
+        .def_readonly("track_gains", &AutoMixer::MixParameters::trackGains)
+        .def_readonly("track_eqs", &AutoMixer::MixParameters::trackEQs)
+        .def_readonly("pan_positions", &AutoMixer::MixParameters::panPositions)
+        .def_readonly("mix_bus_compressor", &AutoMixer::MixParameters::mixBusCompressor)
+        .def_readonly("ducking_compressor", &AutoMixer::MixParameters::duckingCompressor);
+
+    py::enum_<DetectorMode>(m, "DetectorMode")
+        .value("PEAK", DetectorMode::Peak)
+        .value("RMS", DetectorMode::Rms)
+        .value("PROGRAM_DEPENDENT", DetectorMode::ProgramDependent);
 
     // CompressorSettings
     py::class_<CompressorSettings>(m, "CompressorSettings")
@@ -89,16 +565,189 @@ PYBIND11_MODULE(audio_practice_native, m) {
         .def_readwrite("attack", &CompressorSettings::attack)
         .def_readwrite("release", &CompressorSettings::release)
         .def_readwrite("knee", &CompressorSettings::knee)
-        .def_readwrite("makeup_gain", &CompressorSettings::makeupGain);
+        .def_readwrite("makeup_gain", &CompressorSettings::makeupGain)
+        .def_readwrite("detector", &CompressorSettings::detector)
+        .def_readwrite("rms_window", &CompressorSettings::rmsWindow);
 
     // EQBand
-    py::class_<EQBand>(m, "EQBand")
+    py::class_<EQBand> eqBand(m, "EQBand");
+    py::enum_<EQBand::Type>(eqBand, "Type")
+        .value("PEAK", EQBand::PEAK)
+        .value("HIGH_SHELF", EQBand::HIGH_SHELF)
+        .value("LOW_SHELF", EQBand::LOW_SHELF)
+        .value("HIGH_PASS", EQBand::HIGH_PASS)
+        .value("LOW_PASS", EQBand::LOW_PASS);
+    eqBand
         .def(py::init<>())
         .def_readwrite("frequency", &EQBand::frequency)
         .def_readwrite("gain", &EQBand::gain)
-        .def_readwrite("q", &EQBand::q);
+        .def_readwrite("q", &EQBand::q)
+        .def_readwrite("type", &EQBand::type);
+
+    // Effects process writable float32 arrays (1-D mono or channels x
+    // samples) in place with the GIL released. Like AutoMixer, an instance
+    // holds filter/envelope state and must not be used by two threads at once.
+
+    // Compressor
+    py::class_<Compressor> compressor(m, "Compressor");
+    py::enum_<Compressor::LinkMode>(compressor, "LinkMode")
+        .value("MAX", Compressor::LinkMode::Max)
+        .value("SUM", Compressor::LinkMode::Sum);
+    compressor
+        .def(py::init<const CompressorSettings&>(), py::arg("settings") = CompressorSettings())
+        .def("prepare", &Compressor::prepare, py::arg("sample_rate"), py::arg("max_block_size") = 0)
+        .def("reset", &Compressor::reset)
+        .def("set_settings", &Compressor::setSettings, py::arg("settings"))
+        .def("get_settings", &Compressor::getSettings)
+        .def_property("link_mode", &Compressor::getLinkMode, &Compressor::setLinkMode)
+        .def("get_gain_reduction", &Compressor::getGainReduction)
+        .def("process", [](Compressor& comp, const py::array& data, const py::object& sidechain) {
+            size_t numSamples = 0;
+            std::vector<float*> channels = in_place_channels(data, numSamples);
+            
+            if (sidechain.is_none()) {
+                py::gil_scoped_release release;
+                comp.process(channels.data(), channels.size(), numSamples);
+                return;
+            }
+            
+            // The sidechain is only read, so any array converts (once if needed)
+            AudioBuffer key = to_buffer(sidechain);
+            if (key.getNumSamples() < numSamples) {
+                throw std::runtime_error("Sidechain is shorter than the input");
+            }
+            std::vector<const float*> keyChannels(key.getNumChannels());
+            for (size_t ch = 0; ch < keyChannels.size(); ++ch) {
+                keyChannels[ch] = key.getChannelData(ch);
+            }
+            
+            py::gil_scoped_release release;
+            comp.process(keyChannels.data(), keyChannels.size(),
+                         channels.data(), channels.size(), numSamples);
+        }, py::arg("data"), py::arg("sidechain") = py::none(),
+           "Compress in place; channels share one linked detector, driven by the "
+           "sidechain when one is given");
+
+    // Equalizer
+    py::class_<Equalizer> equalizer(m, "Equalizer");
+    py::enum_<Equalizer::ProcessingMode>(equalizer, "ProcessingMode")
+        .value("SERIAL", Equalizer::ProcessingMode::Serial)
+        .value("BLOCK_PARALLEL", Equalizer::ProcessingMode::BlockParallel);
+    py::enum_<Equalizer::Topology>(equalizer, "Topology")
+        .value("BIQUAD", Equalizer::Topology::Biquad)
+        .value("STATE_VARIABLE", Equalizer::Topology::StateVariable);
+    equalizer
+        .def(py::init<>())
+        .def("prepare", &Equalizer::prepare, py::arg("sample_rate"), py::arg("max_block_size") = 0,
+             py::arg("num_channels") = 1)
+        .def("set_band", &Equalizer::setBand, py::arg("index"), py::arg("band"))
+        .def("set_bands", &Equalizer::setBands, py::arg("bands"))
+        .def("clear_bands", &Equalizer::clearBands)
+        .def("get_bands", &Equalizer::getBands)
+        .def("reset", &Equalizer::reset)
+        .def("is_quiescent", &Equalizer::isQuiescent, py::arg("threshold") = 1e-7f)
+        .def_property("smoothing_length", &Equalizer::getSmoothingLength,
+                      &Equalizer::setSmoothingLength)
+        .def_property("processing_mode", &Equalizer::getProcessingMode,
+                      &Equalizer::setProcessingMode)
+        .def_property("topology", &Equalizer::getTopology, &Equalizer::setTopology)
+        .def("process", [](Equalizer& eq, const py::array& data) {
+            size_t numSamples = 0;
+            std::vector<float*> channels = in_place_channels(data, numSamples);
+            py::gil_scoped_release release;
+            eq.process(channels.data(), channels.size(), numSamples);
+        }, py::arg("data"), "Filter in place; each channel keeps its own filter state")
+        .def("magnitude_response", [](Equalizer& eq, FloatArray frequencies) {
+            py::array_t<float> magnitudes(frequencies.size());
+            const float* in = frequencies.data();
+            float* out = magnitudes.mutable_data();
+            const size_t count = frequencies.size();
+            py::gil_scoped_release release;
+            eq.computeMagnitudeResponse(in, out, count);
+            return magnitudes;
+        }, py::arg("frequencies"), "Linear magnitude response at the given frequencies (Hz)");
+
+    // SpectrumAnalyzer
+    py::class_<SpectrumAnalyzer>(m, "SpectrumAnalyzer")
+        .def(py::init<size_t>(), py::arg("fft_size") = 2048)
+        .def("get_fft_size", &SpectrumAnalyzer::getFFTSize)
+        .def("get_frequency_bin", &SpectrumAnalyzer::getFrequencyBin,
+             py::arg("frequency"), py::arg("sample_rate"))
+        .def("get_bin_frequency", &SpectrumAnalyzer::getBinFrequency,
+             py::arg("bin"), py::arg("sample_rate"))
+        .def("analyze", [](SpectrumAnalyzer& analyzer, const py::object& data) -> py::array {
+            AudioBuffer buffer = to_buffer(data);
+            const size_t channels = buffer.getNumChannels();
+            const size_t bins = analyzer.getFFTSize() / 2 + 1;
+            
+            py::array_t<float> result(std::vector<size_t>{channels, bins});
+            float* out = result.mutable_data();
+            {
+                py::gil_scoped_release release;
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    std::vector<float> magnitude =
+                        analyzer.analyze(buffer.getChannelData(ch), buffer.getNumSamples());
+                    std::copy(magnitude.begin(), magnitude.end(), out + ch * bins);
+                }
+            }
+            if (py::array::ensure(data).ndim() == 1) {
+                return result.reshape(std::vector<py::ssize_t>{static_cast<py::ssize_t>(bins)});
+            }
+            return result;
+        }, py::arg("data"),
+           "Average magnitude spectrum; one row per channel for 2-D input");
+
+    // StreamingMixer
+    py::class_<PyStreamingMixer>(m, "StreamingMixer",
+        "Mixes sessions block by block with constant memory. process() takes one "
+        "float32 block per track (channels x samples, or 1-D for mono) and returns a "
+        "2 x samples view of a preallocated output buffer that the next call "
+        "overwrites. Output lags input by get_latency() samples. Not thread-safe.")
+        .def(py::init<const AutoMixerSettings&, const std::vector<size_t>&, size_t>(),
+             py::arg("settings"), py::arg("track_channels"), py::arg("block_size") = 4096)
+        .def("process", &PyStreamingMixer::process, py::arg("blocks"))
+        .def("set_mix_parameters", [](PyStreamingMixer& self,
+                                      const AutoMixer::MixParameters& params) {
+            self.mixer.setMixParameters(params);
+        }, py::arg("params"), "Use fixed parameters, e.g. from AutoMixer.analyze_tracks")
+        .def("reset", [](PyStreamingMixer& self) { self.mixer.reset(); })
+        .def("get_latency", [](const PyStreamingMixer& self) { return self.mixer.getLatency(); })
+        .def("get_block_size", [](const PyStreamingMixer& self) {
+            return self.mixer.getMaxBlockSize();
+        })
+        .def("get_track_gain", [](const PyStreamingMixer& self, size_t track) {
+            if (track >= self.mixer.getNumTracks()) {
+                throw py::index_error("Track index out of range");
+            }
+            return self.mixer.getTrackGain(track);
+        }, py::arg("track"));
+
+    m.def("process_batch", [](const py::sequence& sessions, const AutoMixerSettings& settings,
+                              size_t numThreads) {
+        std::vector<std::vector<AudioBuffer>> batch;
+        batch.reserve(sessions.size());
+        for (py::handle session : sessions) {
+            batch.push_back(to_tracks(session.cast<py::sequence>()));
+        }
+        
+        std::vector<AudioBuffer> mixes;
+        {
+            py::gil_scoped_release release;
+            mixes = AutoMixer::processBatch(batch, settings, numThreads);
+        }
+        
+        py::list results;
+        for (const AudioBuffer& mix : mixes) {
+            results.append(buffer_to_numpy(mix));
+        }
+        return results;
+    }, py::arg("sessions"), py::arg("settings") = AutoMixerSettings(), py::arg("num_threads") = 0,
+       "Mix a list of sessions (each a list of tracks) on native threads; returns one "
+       "2 x samples array per session. num_threads = 0 uses a pool sized to the hardware.");
 
     // Conversion functions
-    m.def("numpy_to_buffer", &numpy_to_buffer, "Convert numpy array to AudioBuffer");
-    m.def("buffer_to_numpy", &buffer_to_numpy, "Convert AudioBuffer to numpy array");
+    m.def("numpy_to_buffer", &numpy_to_buffer, py::arg("array"), py::arg("channels_first") = py::none(),
+          "Wrap a numpy array as an AudioBuffer, without copying when it is float32 "
+          "channels x samples; other dtypes and layouts are converted");
+    m.def("buffer_to_numpy", &buffer_to_numpy, "View an AudioBuffer as a numpy array without copying");
 } 
\ No newline at end of file
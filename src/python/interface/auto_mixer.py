@@ -42,6 +42,7 @@ class AutoMixer:
         
         if self.use_native:
             settings = native.AutoMixerSettings()
+            settings.sample_rate = sample_rate
             settings.target_lufs = target_lufs
             self.native_mixer = native.AutoMixer(settings)
     
@@ -98,21 +99,19 @@ class AutoMixer:
     
     def _process_native(self, tracks: List[AudioFile]) -> np.ndarray:
         """Process using C++ native mixer."""
-        # Convert to native buffers
-        native_buffers = []
+        # float32 arrays are read in place and other dtypes (e.g. soundfile's
+        # float64) converted natively; mono is reshaped explicitly so short
+        # clips never hit the shorter-axis layout guess
+        native_tracks = []
         for track in tracks:
             audio_data = track.get_numpy()
             if audio_data.ndim == 1:
                 audio_data = audio_data.reshape(1, -1)
             
-            buffer = native.numpy_to_buffer(audio_data)
-            native_buffers.append(buffer)
+            native_tracks.append(audio_data)
         
-        # Process with native mixer
-        mixed_buffer = self.native_mixer.process(native_buffers)
-        
-        # Convert back to numpy
-        return native.buffer_to_numpy(mixed_buffer)
+        # Process with native mixer; the result wraps the mix bus without a copy
+        return self.native_mixer.process(native_tracks)
     
     def _process_python(self, tracks: List[AudioFile]) -> np.ndarray:
         """Process using Python/Pedalboard."""
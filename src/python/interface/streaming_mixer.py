@@ -0,0 +1,68 @@
+"""
+Block-by-block mixing for sessions too long to hold in memory.
+"""
+
+import numpy as np
+from typing import Iterable, Iterator, Optional, Sequence
+
+try:
+    from .. import audio_practice_native as native
+    HAS_NATIVE = True
+except ImportError:
+    HAS_NATIVE = False
+
+
+class StreamingMixer:
+    """Streams aligned track blocks through the native mixer.
+    
+    Memory stays constant however long the session is: each call reuses the
+    same native buffers, and float32 (channels x samples) blocks are read
+    without copying. int16, int32 and float64 blocks, and interleaved
+    (samples x channels) ones as read from audio files, are converted into
+    preallocated scratch.
+    """
+    
+    def __init__(self,
+                 track_channels: Sequence[int],
+                 block_size: int = 4096,
+                 settings: Optional["native.AutoMixerSettings"] = None):
+        if not HAS_NATIVE:
+            raise RuntimeError("StreamingMixer needs the C++ native module")
+        self.native_mixer = native.StreamingMixer(
+            settings if settings is not None else native.AutoMixerSettings(),
+            list(track_channels), block_size)
+        self.track_channels = list(track_channels)
+        self.block_size = block_size
+    
+    @property
+    def latency(self) -> int:
+        """Samples the output lags the input."""
+        return self.native_mixer.get_latency()
+    
+    def process(self, blocks: Sequence[np.ndarray]) -> np.ndarray:
+        """Mix one block per track. The result is overwritten by the next call."""
+        return self.native_mixer.process(blocks)
+    
+    def stream(self, block_source: Iterable[Sequence[np.ndarray]]) -> Iterator[np.ndarray]:
+        """Yield mixed blocks for each set of track blocks, then the latency tail.
+        
+        block_source can be e.g. zip() over soundfile.blocks() generators, one
+        per track, transposed to channels x samples.
+        """
+        for blocks in block_source:
+            yield self.process(blocks)
+        
+        # Flush what is still inside the lookahead delays
+        # with contiguous silence, allocated once per block width, so the
+        # native side reads it in place instead of copying a strided slice
+        remaining = self.latency
+        width = 0
+        silence = []
+        while remaining > 0:
+            n = min(remaining, self.block_size)
+            if n != width:
+                width = n
+                silence = [np.zeros((channels, n), dtype=np.float32)
+                           for channels in self.track_channels]
+            yield self.process(silence)
+            remaining -= n
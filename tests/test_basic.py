@@ -2,15 +2,24 @@
 Basic unit tests for AudioPractice.
 """
 
+import pickle
 import pytest
 import numpy as np
 import sys
+from concurrent.futures import ThreadPoolExecutor
+from multiprocessing import Pool
 from pathlib import Path
 
 # Add parent directory to path
 sys.path.append(str(Path(__file__).parent.parent / "src" / "python"))
 
-from audio_practice import AudioFile, AutoMixer, PedalboardProcessor
+from audio_practice import AudioFile, AutoMixer, PedalboardProcessor, StreamingMixer
+
+try:
+    from audio_practice import audio_practice_native as native
+    HAS_NATIVE = True
+except ImportError:
+    HAS_NATIVE = False
 
 
 class TestAudioFile:
@@ -161,5 +170,208 @@ class TestPedalboardProcessor:
         assert np.max(np.abs(mixed)) <= 1.0  # Should not clip
 
 
+def _make_shared(samples):
+    """Worker side of the shared-buffer return test."""
+    return native.AudioBuffer.share(np.full((2, samples), 0.25, dtype=np.float32))
+
+
+@pytest.mark.skipif(not HAS_NATIVE, reason="native module not built")
+class TestNativeBindings:
+    """Test the C++ bindings' zero-copy and conversion paths."""
+    
+    def test_buffer_to_numpy_shares_memory(self):
+        """Test that buffer_to_numpy views the buffer's samples."""
+        buffer = native.AudioBuffer(2, 64)
+        view = native.buffer_to_numpy(buffer)
+        assert view.shape == (2, 64)
+        
+        view[1, 3] = 0.5
+        buffer.apply_gain(2.0)
+        assert view[1, 3] == 1.0
+        assert np.asarray(buffer)[1, 3] == 1.0
+    
+    def test_audio_buffer_wraps_array(self):
+        """Test that AudioBuffer(array) shares a float32 array's memory."""
+        data = np.zeros((2, 64), dtype=np.float32)
+        buffer = native.AudioBuffer(data)
+        assert np.shares_memory(native.buffer_to_numpy(buffer), data)
+        
+        data[0, 5] = 1.0
+        buffer.apply_gain(0.5)
+        assert data[0, 5] == 0.5
+    
+    def test_threaded_mixes_match_serial(self):
+        """Test that mixers on separate threads render what they render serially."""
+        sessions = [[(np.random.randn(1, 9600) * 0.1).astype(np.float32) for _ in range(3)]
+                    for _ in range(4)]
+        
+        def render(tracks):
+            return native.AutoMixer(native.AutoMixerSettings()).process(tracks)
+        
+        serial = [render(tracks) for tracks in sessions]
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            threaded = list(pool.map(render, sessions))
+        assert all(np.array_equal(a, b) for a, b in zip(serial, threaded))
+    
+    def test_analyze_tracks(self):
+        """Test that analyze_tracks returns parameters for every track."""
+        tracks = [(np.random.randn(1, 4800) * 0.1).astype(np.float32),
+                  np.random.randn(2, 4800) * 0.1]
+        params = native.AutoMixer(native.AutoMixerSettings()).analyze_tracks(tracks)
+        
+        assert len(params.track_gains) == 2
+        assert len(params.track_eqs) == 2
+        assert len(params.pan_positions) == 2
+    
+    def test_int16_input(self):
+        """Test that int16 samples convert to full-scale floats."""
+        data = (np.arange(128, dtype=np.int16).reshape(2, 64) * 256)
+        buffer = native.AudioBuffer(data)
+        assert buffer.get_num_channels() == 2
+        assert np.allclose(np.asarray(buffer), data / 32768.0)
+    
+    def test_float64_input(self):
+        """Test that float64 samples convert to float32."""
+        data = np.random.randn(2, 100)
+        buffer = native.AudioBuffer(data)
+        assert np.allclose(np.asarray(buffer), data.astype(np.float32))
+    
+    def test_interleaved_input(self):
+        """Test that samples x channels input is deinterleaved."""
+        planar = np.random.randn(2, 1000).astype(np.float32)
+        interleaved = np.ascontiguousarray(planar.T)
+        buffer = native.AudioBuffer(interleaved)
+        assert np.array_equal(np.asarray(buffer), planar)
+        
+        # int16 read straight from an audio file
+        pcm = (interleaved * 8000).astype(np.int16)
+        buffer = native.AudioBuffer(pcm)
+        assert np.allclose(np.asarray(buffer), pcm.T / 32768.0)
+    
+    def test_strided_int16_input(self):
+        """Test that a strided int16 view keeps its PCM scaling."""
+        pcm = (np.random.randn(1000, 4) * 8000).astype(np.int16)
+        view = pcm[:, :2]
+        buffer = native.AudioBuffer(view)
+        assert buffer.get_num_channels() == 2
+        assert np.allclose(np.asarray(buffer), view.T / 32768.0)
+    
+    def test_byte_swapped_input(self):
+        """Test that non-native byte order PCM is scaled like native."""
+        pcm = (np.random.randn(2, 500) * 8000).astype(np.int16)
+        buffer = native.AudioBuffer(pcm.astype(pcm.dtype.newbyteorder()))
+        assert np.allclose(np.asarray(buffer), pcm / 32768.0)
+    
+    def test_other_integer_widths(self):
+        """Test that 8-bit, unsigned and 64-bit PCM map full scale to +-1."""
+        unsigned = np.array([[0, 128, 255]], dtype=np.uint8)
+        assert np.allclose(np.asarray(native.AudioBuffer(unsigned)),
+                           [[-1.0, 0.0, 127 / 128]])
+        signed = np.array([[-128, 0, 64]], dtype=np.int8)
+        assert np.allclose(np.asarray(native.AudioBuffer(signed)), [[-1.0, 0.0, 0.5]])
+        wide = np.array([[-2**63, 2**62]], dtype=np.int64)
+        assert np.allclose(np.asarray(native.AudioBuffer(wide)), [[-1.0, 0.5]])
+        
+        with pytest.raises(TypeError):
+            native.AudioBuffer(np.zeros((2, 10), dtype=bool))
+    
+    def test_compressor_in_place(self):
+        """Test that Compressor.process modifies the array in place."""
+        settings = native.CompressorSettings()
+        settings.threshold = -20.0
+        settings.ratio = 8.0
+        settings.attack = 1.0
+        compressor = native.Compressor(settings)
+        compressor.prepare(48000)
+        
+        t = np.arange(48000) / 48000
+        data = (0.9 * np.sin(2 * np.pi * 440 * t)).astype(np.float32).reshape(1, -1)
+        original = data.copy()
+        compressor.process(data)
+        
+        assert np.max(np.abs(data[:, 24000:])) < np.max(np.abs(original[:, 24000:]))
+        with pytest.raises(TypeError):
+            compressor.process(original.astype(np.float64))
+    
+    def test_equalizer_in_place(self):
+        """Test that Equalizer.process filters the array in place."""
+        band = native.EQBand()
+        band.type = native.EQBand.Type.HIGH_PASS
+        band.frequency = 1000.0
+        band.q = 0.707
+        equalizer = native.Equalizer()
+        equalizer.set_band(0, band)
+        equalizer.prepare(48000)
+        
+        t = np.arange(48000) / 48000
+        data = np.sin(2 * np.pi * 50 * t).astype(np.float32)
+        equalizer.process(data)
+        
+        # A 50 Hz tone is far below the cutoff
+        assert np.max(np.abs(data[24000:])) < 0.1
+    
+    def test_process_batch(self):
+        """Test mixing several sessions on native threads."""
+        sessions = [
+            [np.random.randn(1, 4800).astype(np.float32) * 0.1,
+             np.random.randn(2, 4800) * 0.1],
+            [np.random.randn(1, 2400).astype(np.float32) * 0.1],
+        ]
+        mixes = native.process_batch(sessions, native.AutoMixerSettings(), 2)
+        
+        assert len(mixes) == 2
+        assert mixes[0].shape == (2, 4800)
+        assert mixes[1].shape == (2, 2400)
+        assert all(np.all(np.isfinite(mix)) for mix in mixes)
+    
+    def test_streaming_mixer_process(self):
+        """Test mixing one block of mono float32 and interleaved int16 stereo."""
+        mixer = native.StreamingMixer(native.AutoMixerSettings(), [1, 2], 256)
+        mono = (np.random.randn(256) * 0.1).astype(np.float32)
+        stereo = (np.random.randn(256, 2) * 3000).astype(np.int16)
+        
+        out = mixer.process([mono, stereo])
+        assert out.shape == (2, 256)
+        assert out.dtype == np.float32
+        assert np.all(np.isfinite(out))
+        
+        with pytest.raises(RuntimeError):
+            mixer.process([mono, stereo[:128]])
+    
+    def test_streaming_mixer_stream(self):
+        """Test that stream() yields every input sample plus the latency tail."""
+        mixer = StreamingMixer([1], block_size=256)
+        blocks = [[(np.random.randn(1, 256) * 0.1).astype(np.float32)] for _ in range(3)]
+        
+        total = sum(out.shape[1] for out in mixer.stream(blocks))
+        assert total == 3 * 256 + mixer.latency
+    
+    def test_pickle_shared_buffer(self):
+        """Test that a shared buffer pickles as a handle to the same samples."""
+        data = np.arange(128, dtype=np.float32).reshape(2, 64)
+        buffer = native.AudioBuffer.share(data)
+        assert buffer.shared_name is not None
+        
+        clone = pickle.loads(pickle.dumps(buffer))
+        assert clone.shared_name == buffer.shared_name
+        assert np.array_equal(np.asarray(clone), data)
+        
+        np.asarray(clone)[0, 0] = -1.0
+        assert np.asarray(buffer)[0, 0] == -1.0
+        
+        # Private buffers pickle by value
+        private = pickle.loads(pickle.dumps(native.AudioBuffer(data)))
+        assert private.shared_name is None
+        assert np.array_equal(np.asarray(private), data)
+    
+    def test_shared_buffer_from_worker(self):
+        """Test that a worker can create a shared buffer and return it."""
+        with Pool(1) as pool:
+            buffer = pool.apply(_make_shared, (64,))
+        
+        assert buffer.shared_name is not None
+        assert np.all(np.asarray(buffer) == 0.25)
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"]) 
\ No newline at end of file
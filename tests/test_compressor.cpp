@@ -0,0 +1,378 @@
+// Compressor against a per-sample scalar evaluation of the same gain
+// computer (must match bit for bit, however audio is blocked) and against
+// the original log10/pow gain computer (within 0.01 dB). Linked multichannel
+// processing must apply one gain to all channels, and a CompressorBank must
+// match one Compressor per channel, also after a resize. The RMS and program-dependent detectors
+// are checked for their steady state and release behaviour, and a shared
+// EnvelopeDetector must drive applyEnvelope exactly like the own detector.
+// An external sidechain must be read in place, including a lookahead view.
+
+#include "dsp/envelope_detector.h"
+#include "dsp/simd_math.h"
+#include "effects/compressor.h"
+#include "effects/compressor_bank.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+constexpr double kMaxErrorDb = 0.01;
+
+// One sample at a time, all scalar
+std::vector<float> scalarProcess(const CompressorSettings& s, const std::vector<float>& input) {
+    const float log2PerDb = 1.0f / 6.02059991f;
+    const float attack = std::exp(-1.0f / (s.attack * kSampleRate / 1000.0f));
+    const float release = std::exp(-1.0f / (s.release * kSampleRate / 1000.0f));
+    const float threshold = s.threshold * log2PerDb;
+    const float kneeStart = (s.threshold - s.knee / 2.0f) * log2PerDb;
+    const float invKnee = s.knee > 0.0f ? 1.0f / (s.knee * log2PerDb) : 1e30f;
+    const float slope = 1.0f - 1.0f / s.ratio;
+    const float makeup = s.makeupGain * log2PerDb;
+
+    std::vector<float> out = input;
+    float envelope = 0.0f;
+    for (auto& sample : out) {
+        float level = std::abs(sample);
+        float attacked = std::fma(attack, envelope, (1.0f - attack) * level);
+        float released = std::fma(release, envelope, (1.0f - release) * level);
+        envelope = attack <= release ? std::max(attacked, released) : std::min(attacked, released);
+
+        float x = simd::log2_ss(std::max(envelope, 1e-10f));
+        float progress = std::max(std::min((x - kneeStart) * invKnee, 1.0f), 0.0f);
+        float gainLog2 = makeup - (x - threshold) * slope * progress * progress;
+        sample *= simd::exp2_ss(gainLog2);
+    }
+    return out;
+}
+
+// The gain computer Compressor used before the log2 rewrite
+std::vector<float> originalProcess(const CompressorSettings& s, const std::vector<float>& input) {
+    const float attack = std::exp(-1.0f / (s.attack * kSampleRate / 1000.0f));
+    const float release = std::exp(-1.0f / (s.release * kSampleRate / 1000.0f));
+
+    std::vector<double> out(input.begin(), input.end());
+    double envelope = 0.0;
+    for (auto& sample : out) {
+        double level = std::abs(sample);
+        envelope = level + (envelope - level) * (level > envelope ? attack : release);
+
+        double inputDb = 20.0 * std::log10(std::max(envelope, 1e-10));
+        double kneeStart = s.threshold - s.knee / 2.0;
+        double kneeEnd = s.threshold + s.knee / 2.0;
+        double reduction = 0.0;
+        if (inputDb > kneeEnd) {
+            reduction = (inputDb - s.threshold) * (1.0 - 1.0 / s.ratio);
+        } else if (inputDb > kneeStart) {
+            double progress = (inputDb - kneeStart) / s.knee;
+            reduction = (inputDb - s.threshold) * (1.0 - 1.0 / s.ratio) * progress * progress;
+        }
+        sample *= std::pow(10.0, (s.makeupGain - reduction) / 20.0);
+    }
+    return std::vector<float>(out.begin(), out.end());
+}
+
+std::vector<float> compressorProcess(const CompressorSettings& s, const std::vector<float>& input,
+                                     size_t maxBlockSize, bool unevenChunks) {
+    Compressor compressor(s);
+    compressor.prepare(kSampleRate, maxBlockSize);
+
+    std::vector<float> data = input;
+    const size_t chunks[] = {1, 7, 64, 13, 512, 8, 1000};
+    size_t pos = 0;
+    for (size_t c = 0; pos < data.size(); ++c) {
+        size_t n = std::min(unevenChunks ? chunks[c % 7] : maxBlockSize, data.size() - pos);
+        compressor.process(&data[pos], n);
+        pos += n;
+    }
+    return data;
+}
+
+CompressorSettings makeSettings(float threshold, float ratio, float attack, float release,
+                                float knee, float makeup) {
+    CompressorSettings s;
+    s.threshold = threshold;
+    s.ratio = ratio;
+    s.attack = attack;
+    s.release = release;
+    s.knee = knee;
+    s.makeupGain = makeup;
+    return s;
+}
+
+} // namespace
+
+int main() {
+    // Noise with a level sweep through the knee
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(96000);
+    for (size_t i = 0; i < input.size(); ++i) {
+        float level = std::pow(10.0f, -2.5f * (0.5f + 0.5f * std::sin(static_cast<float>(i) * 2e-4f)));
+        input[i] = dist(rng) * level;
+    }
+
+    struct Case {
+        const char* name;
+        CompressorSettings settings;
+    };
+    const Case cases[] = {
+        {"default", CompressorSettings{}},
+        {"bus glue", makeSettings(-20.0f, 2.0f, 30.0f, 300.0f, 6.0f, 2.0f)},
+        {"hard knee", makeSettings(-18.0f, 8.0f, 1.0f, 80.0f, 0.0f, 0.0f)},
+        {"slow attack", makeSettings(-24.0f, 3.0f, 200.0f, 50.0f, 4.0f, 0.0f)},
+    };
+
+    std::printf("%-12s %10s %10s %14s\n", "case", "block 512", "uneven", "vs log10 (dB)");
+
+    int failures = 0;
+    for (const auto& tc : cases) {
+        std::vector<float> ref = scalarProcess(tc.settings, input);
+        std::vector<float> blocked = compressorProcess(tc.settings, input, 512, false);
+        std::vector<float> uneven = compressorProcess(tc.settings, input, 256, true);
+
+        bool blockedSame = std::memcmp(ref.data(), blocked.data(), ref.size() * sizeof(float)) == 0;
+        bool unevenSame = std::memcmp(ref.data(), uneven.data(), ref.size() * sizeof(float)) == 0;
+
+        std::vector<float> original = originalProcess(tc.settings, input);
+        double maxErrDb = 0.0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (std::abs(input[i]) > 1e-6f) {
+                maxErrDb = std::max(maxErrDb, std::abs(20.0 * std::log10(
+                    static_cast<double>(blocked[i]) / original[i])));
+            }
+        }
+
+        bool ok = blockedSame && unevenSame && maxErrDb < kMaxErrorDb;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10s %10s %14.2e  %s\n", tc.name, blockedSame ? "same" : "DIFF",
+                    unevenSame ? "same" : "DIFF", maxErrDb, ok ? "ok" : "FAIL");
+    }
+
+    // A centered source through a linked stereo compressor behaves as mono,
+    // and an off-center one gets the same gain on both sides
+    for (auto mode : {Compressor::LinkMode::Max, Compressor::LinkMode::Sum}) {
+        const char* name = mode == Compressor::LinkMode::Max ? "link max" : "link sum";
+        std::vector<float> left = input;
+        std::vector<float> right = input;
+        std::vector<float> quietLeft = input;
+        std::vector<float> quietRight(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            quietRight[i] = input[i] * 0.25f;
+        }
+
+        Compressor centered;
+        centered.setLinkMode(mode);
+        centered.prepare(kSampleRate, 512);
+        float* centeredChannels[] = {left.data(), right.data()};
+        centered.process(centeredChannels, 2, input.size());
+
+        Compressor panned;
+        panned.setLinkMode(mode);
+        panned.prepare(kSampleRate, 512);
+        float* pannedChannels[] = {quietLeft.data(), quietRight.data()};
+        panned.process(pannedChannels, 2, input.size());
+
+        std::vector<float> mono = scalarProcess(CompressorSettings{}, input);
+        bool monoSame = std::memcmp(mono.data(), left.data(), mono.size() * sizeof(float)) == 0 &&
+                        std::memcmp(mono.data(), right.data(), mono.size() * sizeof(float)) == 0;
+
+        bool sameGain = true;
+        for (size_t i = 0; i < input.size(); ++i) {
+            sameGain = sameGain && quietLeft[i] * 0.25f == quietRight[i];
+        }
+
+        bool ok = monoSame && sameGain;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10s %10s %14s  %s\n", name, monoSame ? "same" : "DIFF",
+                    sameGain ? "same" : "DIFF", "", ok ? "ok" : "FAIL");
+    }
+
+    // Bank of 13 (one full lane group and a partial one) with mixed
+    // settings against separate compressors, in uneven blocks
+    {
+        const size_t numTracks = 13;
+        CompressorBank bank(numTracks);
+        bank.prepare(kSampleRate, 512);
+        std::vector<std::vector<float>> banked(numTracks);
+        std::vector<std::vector<float>> separate(numTracks);
+        std::vector<float*> channels(numTracks);
+        for (size_t t = 0; t < numTracks; ++t) {
+            const CompressorSettings& s = cases[t % 4].settings;
+            bank.setSettings(t, s);
+            banked[t].resize(input.size());
+            for (size_t i = 0; i < input.size(); ++i) {
+                banked[t][i] = input[(i + 1000 * t) % input.size()];
+            }
+            separate[t] = compressorProcess(s, banked[t], 300, true);
+            channels[t] = banked[t].data();
+        }
+
+        const size_t chunks[] = {5, 64, 1, 333, 8};
+        size_t pos = 0;
+        for (size_t c = 0; pos < input.size(); ++c) {
+            size_t n = std::min(chunks[c % 5], input.size() - pos);
+            std::vector<float*> offsetChannels(numTracks);
+            for (size_t t = 0; t < numTracks; ++t) {
+                offsetChannels[t] = channels[t] + pos;
+            }
+            bank.process(offsetChannels.data(), n);
+            pos += n;
+        }
+
+        bool same = true;
+        for (size_t t = 0; t < numTracks; ++t) {
+            same = same && std::memcmp(banked[t].data(), separate[t].data(), input.size() * sizeof(float)) == 0;
+        }
+        failures += same ? 0 : 1;
+        std::printf("%-12s %10s %10s %14s  %s\n", "bank", same ? "same" : "DIFF", "", "", same ? "ok" : "FAIL");
+    }
+
+    // Shrinking and growing again gives fresh compressors: settings and
+    // envelope of the removed ones do not carry over
+    {
+        CompressorBank bank(3);
+        bank.prepare(kSampleRate, 512);
+        std::vector<std::vector<float>> loud(3, input);
+        std::vector<float*> channels = {loud[0].data(), loud[1].data(), loud[2].data()};
+        for (size_t t = 0; t < 3; ++t) {
+            bank.setSettings(t, cases[1].settings);
+        }
+        bank.process(channels.data(), input.size());
+        
+        bank.resize(1);
+        bank.resize(3);
+        std::vector<std::vector<float>> again(3, input);
+        channels = {again[0].data(), again[1].data(), again[2].data()};
+        bank.process(channels.data(), input.size());
+        
+        std::vector<float> fresh = compressorProcess(CompressorSettings{}, input, 512, false);
+        bool same = std::memcmp(again[1].data(), fresh.data(), input.size() * sizeof(float)) == 0 &&
+                    std::memcmp(again[2].data(), fresh.data(), input.size() * sizeof(float)) == 0;
+        failures += same ? 0 : 1;
+        std::printf("%-12s %10s %10s %14s  %s\n", "bank resize", same ? "same" : "DIFF", "", "",
+                    same ? "ok" : "FAIL");
+    }
+
+    // RMS of a steady sine settles at amplitude / sqrt(2)
+    {
+        EnvelopeDetector detector({DetectorMode::Rms, 1.0f, 50.0f, 10.0f});
+        detector.prepare(kSampleRate, 512);
+        std::vector<float> sine(24000);
+        std::vector<float> envelope(sine.size());
+        for (size_t i = 0; i < sine.size(); ++i) {
+            sine[i] = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * 1000.0f * i / kSampleRate);
+        }
+        detector.process(sine.data(), envelope.data(), sine.size());
+        float err = std::abs(envelope.back() - 0.5f / std::sqrt(2.0f));
+        bool ok = err < 1e-3f;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10.2e %10s %14s  %s\n", "rms sine", err, "", "", ok ? "ok" : "FAIL");
+    }
+
+    // Program-dependent release: as fast as the peak detector after a short
+    // burst, slower after sustained material
+    {
+        auto afterSilence = [](DetectorMode mode, size_t burst) {
+            EnvelopeDetector detector({mode, 1.0f, 50.0f, 10.0f});
+            detector.prepare(kSampleRate, 0);
+            std::vector<float> signal(burst + 4800, 0.0f);
+            std::fill(signal.begin(), signal.begin() + burst, 0.5f);
+            std::vector<float> envelope(signal.size());
+            detector.process(signal.data(), envelope.data(), signal.size());
+            return envelope.back();
+        };
+        float peakShort = afterSilence(DetectorMode::Peak, 240);
+        float autoShort = afterSilence(DetectorMode::ProgramDependent, 240);
+        float peakLong = afterSilence(DetectorMode::Peak, 96000);
+        float autoLong = afterSilence(DetectorMode::ProgramDependent, 96000);
+        bool ok = autoShort < 1.2f * peakShort && autoLong > 4.0f * peakLong;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10.4f %10.4f %14s  %s\n", "auto release", autoShort / peakShort,
+                    autoLong / peakLong, "", ok ? "ok" : "FAIL");
+    }
+
+    // One shared detector feeding applyEnvelope on two channels matches a
+    // compressor running its own RMS detector, however audio is blocked
+    {
+        CompressorSettings s = cases[1].settings;
+        s.detector = DetectorMode::Rms;
+        std::vector<float> own = compressorProcess(s, input, 512, false);
+        std::vector<float> uneven = compressorProcess(s, input, 256, true);
+
+        EnvelopeDetector detector({s.detector, s.attack, s.release, s.rmsWindow});
+        detector.prepare(kSampleRate, 512);
+        std::vector<float> envelope(input.size());
+        detector.process(input.data(), envelope.data(), input.size());
+
+        Compressor compressor(s);
+        compressor.prepare(kSampleRate, 512);
+        std::vector<float> left = input;
+        std::vector<float> right = input;
+        float* channels[] = {left.data(), right.data()};
+        compressor.applyEnvelope(envelope.data(), channels, 2, input.size());
+
+        bool unevenSame = std::memcmp(own.data(), uneven.data(), own.size() * sizeof(float)) == 0;
+        bool sharedSame = std::memcmp(own.data(), left.data(), own.size() * sizeof(float)) == 0 &&
+                          std::memcmp(own.data(), right.data(), own.size() * sizeof(float)) == 0;
+        bool ok = unevenSame && sharedSame;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10s %10s %14s  %s\n", "shared rms", sharedSame ? "same" : "DIFF",
+                    unevenSame ? "same" : "DIFF", "", ok ? "ok" : "FAIL");
+    }
+
+    // Sidechain: music ducked by a key signal read 480 samples ahead, mono
+    // and as an identical stereo pair, against a shared-envelope reference
+    {
+        const size_t lookahead = 480;
+        std::vector<float> key(input.size() + lookahead, 0.0f);
+        for (size_t i = 0; i < input.size(); ++i) {
+            key[i] = input[(i + 30000) % input.size()];
+        }
+        CompressorSettings s = cases[0].settings;
+
+        EnvelopeDetector detector({s.detector, s.attack, s.release, s.rmsWindow});
+        detector.prepare(kSampleRate, 512);
+        std::vector<float> envelope(input.size());
+        detector.process(key.data() + lookahead, envelope.data(), input.size());
+        Compressor reference(s);
+        reference.prepare(kSampleRate, 512);
+        std::vector<float> expected = input;
+        reference.applyEnvelope(envelope.data(), expected.data(), input.size());
+
+        Compressor mono(s);
+        mono.prepare(kSampleRate, 256);
+        std::vector<float> monoOut = input;
+        Compressor stereo(s);
+        stereo.prepare(kSampleRate, 256);
+        std::vector<float> left = input;
+        std::vector<float> right = input;
+
+        const size_t chunks[] = {1, 7, 64, 13, 512, 8, 1000};
+        size_t pos = 0;
+        for (size_t c = 0; pos < input.size(); ++c) {
+            size_t n = std::min(chunks[c % 7], input.size() - pos);
+            mono.process(key.data() + lookahead + pos, monoOut.data() + pos, n);
+            const float* keys[] = {key.data() + lookahead + pos, key.data() + lookahead + pos};
+            float* channels[] = {left.data() + pos, right.data() + pos};
+            stereo.process(keys, 2, channels, 2, n);
+            pos += n;
+        }
+
+        bool monoSame = std::memcmp(expected.data(), monoOut.data(), input.size() * sizeof(float)) == 0;
+        bool stereoSame = std::memcmp(expected.data(), left.data(), input.size() * sizeof(float)) == 0 &&
+                          std::memcmp(expected.data(), right.data(), input.size() * sizeof(float)) == 0;
+        bool ok = monoSame && stereoSame;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %10s %10s %14s  %s\n", "sidechain", monoSame ? "same" : "DIFF",
+                    stereoSame ? "same" : "DIFF", "", ok ? "ok" : "FAIL");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
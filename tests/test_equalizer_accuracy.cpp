@@ -0,0 +1,225 @@
+// Accuracy harness: the fused, block-parallel and state-variable Equalizer
+// kernels against the original per-band direct form I loop.
+
+#include "effects/equalizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+constexpr double kTolerance = 1e-4;  // max abs error for a full-scale signal
+
+// Reference: one direct form I pass per band, as Equalizer::process used to run
+template <typename Real>
+std::vector<float> referenceProcess(const std::vector<EQBand>& bands, const std::vector<float>& input) {
+    std::vector<Real> data(input.begin(), input.end());
+    
+    for (const auto& band : bands) {
+        BiquadCoeffs c = Equalizer::calculateCoeffs(band, kSampleRate);
+        Real x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        
+        for (auto& sample : data) {
+            Real input = sample;
+            Real output = c.a0 * input + c.a1 * x1 + c.a2 * x2 - c.b1 * y1 - c.b2 * y2;
+            x2 = x1;
+            x1 = input;
+            y2 = y1;
+            y1 = output;
+            sample = output;
+        }
+    }
+    
+    return std::vector<float>(data.begin(), data.end());
+}
+
+// Process in uneven chunks so state hand-off and block tails are exercised
+std::vector<float> equalizerProcess(const std::vector<EQBand>& bands, const std::vector<float>& input,
+                                    Equalizer::ProcessingMode mode,
+                                    Equalizer::Topology topology = Equalizer::Topology::Biquad) {
+    Equalizer eq;
+    eq.setProcessingMode(mode);
+    eq.setTopology(topology);
+    for (size_t i = 0; i < bands.size(); ++i) {
+        eq.setBand(i, bands[i]);
+    }
+    
+    std::vector<float> data = input;
+    const size_t chunks[] = {1, 7, 64, 13, 512, 8, 1000};
+    size_t pos = 0;
+    for (size_t c = 0; pos < data.size(); ++c) {
+        size_t n = std::min(chunks[c % 7], data.size() - pos);
+        eq.process(&data[pos], n);
+        pos += n;
+    }
+    
+    return data;
+}
+
+double maxError(const std::vector<float>& a, const std::vector<float>& b) {
+    double err = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        err = std::max(err, std::abs(static_cast<double>(a[i]) - b[i]));
+    }
+    return err;
+}
+
+EQBand peak(float frequency, float gain, float q, EQBand::Type type = EQBand::PEAK) {
+    EQBand band;
+    band.frequency = frequency;
+    band.gain = gain;
+    band.q = q;
+    band.type = type;
+    return band;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(48000);
+    for (auto& s : input) {
+        s = dist(rng);
+    }
+    
+    struct Case {
+        const char* name;
+        std::vector<EQBand> bands;
+    };
+    
+    std::vector<Case> cases = {
+        {"single peak", {peak(1000.0f, 6.0f, 0.7f)}},
+        {"dialogue cut/boost", {peak(120.0f, -4.0f, 0.7f), peak(3000.0f, 3.0f, 1.4f), peak(8000.0f, -2.0f, 2.0f)}},
+        {"narrow low band", {peak(40.0f, 9.0f, 8.0f)}},
+        {"near nyquist", {peak(20000.0f, -6.0f, 0.5f)}},
+        {"six bands", {peak(80.0f, 3.0f, 1.0f), peak(250.0f, -2.0f, 1.0f), peak(800.0f, 2.0f, 2.0f),
+                       peak(2500.0f, -3.0f, 1.5f), peak(6000.0f, 4.0f, 0.7f), peak(12000.0f, -1.0f, 0.7f)}},
+        {"shelves", {peak(150.0f, 4.0f, 0.7f, EQBand::LOW_SHELF), peak(8000.0f, -5.0f, 0.7f, EQBand::HIGH_SHELF)}},
+        {"band limit", {peak(80.0f, 0.0f, 0.707f, EQBand::HIGH_PASS), peak(15000.0f, 0.0f, 0.707f, EQBand::LOW_PASS)}},
+    };
+    
+    // Errors are against the float direct form loop. Narrow low-frequency
+    // bands are ill-conditioned in float, so the allowance grows with the
+    // reference's own error against a double-precision run.
+    std::printf("%-20s %10s %10s %10s %10s\n", "case", "serial", "block", "svf", "df1 vs f64");
+    
+    int failures = 0;
+    for (const auto& tc : cases) {
+        std::vector<float> ref = referenceProcess<float>(tc.bands, input);
+        double serialErr = maxError(ref, equalizerProcess(tc.bands, input, Equalizer::ProcessingMode::Serial));
+        double blockErr = maxError(ref, equalizerProcess(tc.bands, input, Equalizer::ProcessingMode::BlockParallel));
+        double svfErr = maxError(ref, equalizerProcess(tc.bands, input, Equalizer::ProcessingMode::Serial,
+                                                       Equalizer::Topology::StateVariable));
+        double refErr = maxError(ref, referenceProcess<double>(tc.bands, input));
+        
+        double allowed = kTolerance + 2.0 * refErr;
+        bool ok = serialErr < allowed && blockErr < allowed && svfErr < allowed;
+        failures += ok ? 0 : 1;
+        std::printf("%-20s %10.2e %10.2e %10.2e %10.2e  %s\n",
+                    tc.name, serialErr, blockErr, svfErr, refErr, ok ? "ok" : "FAIL");
+    }
+    
+    // Multichannel processing matches one equalizer per channel, including
+    // across a band change that ramps mid-stream
+    for (auto topology : {Equalizer::Topology::Biquad, Equalizer::Topology::StateVariable}) {
+        std::vector<float> left = input;
+        std::vector<float> right(input.rbegin(), input.rend());
+        std::vector<float> refLeft = left;
+        std::vector<float> refRight = right;
+        
+        Equalizer stereo, monoLeft, monoRight;
+        for (Equalizer* eq : {&stereo, &monoLeft, &monoRight}) {
+            eq->setTopology(topology);
+            eq->prepare(kSampleRate, 512, eq == &stereo ? 2 : 1);
+            eq->setBand(0, peak(1000.0f, 6.0f, 0.7f));
+        }
+        
+        for (size_t pos = 0; pos < input.size(); pos += 512) {
+            if (pos == 4096) {
+                for (Equalizer* eq : {&stereo, &monoLeft, &monoRight}) {
+                    eq->setBand(0, peak(2000.0f, -3.0f, 1.0f));
+                    eq->setBand(1, peak(200.0f, 4.0f, 0.7f));
+                }
+            }
+            const size_t n = std::min<size_t>(512, input.size() - pos);
+            float* channels[] = {&left[pos], &right[pos]};
+            stereo.process(channels, 2, n);
+            monoLeft.process(&refLeft[pos], n);
+            monoRight.process(&refRight[pos], n);
+        }
+        
+        double err = std::max(maxError(refLeft, left), maxError(refRight, right));
+        bool ok = err == 0.0;
+        failures += ok ? 0 : 1;
+        std::printf("%-20s %10.2e  %s\n",
+                    topology == Equalizer::Topology::Biquad ? "stereo biquad" : "stereo svf",
+                    err, ok ? "ok" : "FAIL");
+    }
+    
+    // setBands() resolves through the cache up front and ramps like setBand()
+    {
+        std::vector<float> viaSetBands = input;
+        std::vector<float> viaSetBand = input;
+        const std::vector<EQBand> before = {peak(500.0f, 3.0f, 1.0f), peak(4000.0f, -2.0f, 0.7f)};
+        const std::vector<EQBand> after = {peak(700.0f, -4.0f, 1.0f), peak(5000.0f, 2.0f, 0.7f)};
+        Equalizer eq, ref;
+        eq.setBands(before);
+        eq.prepare(kSampleRate, 512, 1);
+        ref.setBand(0, before[0]);
+        ref.setBand(1, before[1]);
+        ref.prepare(kSampleRate, 512);
+        
+        for (size_t pos = 0; pos < input.size(); pos += 512) {
+            if (pos == 4096) {
+                eq.setBands(after);
+                ref.setBand(0, after[0]);
+                ref.setBand(1, after[1]);
+            }
+            const size_t n = std::min<size_t>(512, input.size() - pos);
+            eq.process(&viaSetBands[pos], n);
+            ref.process(&viaSetBand[pos], n);
+        }
+        
+        double err = maxError(viaSetBand, viaSetBands);
+        bool ok = err < kTolerance;
+        failures += ok ? 0 : 1;
+        std::printf("%-20s %10.2e  %s\n", "set bands", err, ok ? "ok" : "FAIL");
+    }
+    
+    // Switching to block-parallel mid-ramp still lands on the target filter
+    {
+        std::vector<float> switched = input;
+        std::vector<float> serial = input;
+        Equalizer eq, ref;
+        for (Equalizer* e : {&eq, &ref}) {
+            e->prepare(kSampleRate, 512);
+            e->setBand(0, peak(1000.0f, 0.0f, 1.0f));
+        }
+        
+        for (size_t pos = 0; pos < input.size(); pos += 256) {
+            if (pos == 512) {
+                eq.setBand(0, peak(1000.0f, 12.0f, 1.0f));
+                ref.setBand(0, peak(1000.0f, 12.0f, 1.0f));
+            }
+            if (pos == 768) {
+                eq.setProcessingMode(Equalizer::ProcessingMode::BlockParallel);
+            }
+            const size_t n = std::min<size_t>(256, input.size() - pos);
+            eq.process(&switched[pos], n);
+            ref.process(&serial[pos], n);
+        }
+        
+        double err = maxError(serial, switched);
+        bool ok = err < kTolerance;
+        failures += ok ? 0 : 1;
+        std::printf("%-20s %10.2e  %s\n", "mode switch in ramp", err, ok ? "ok" : "FAIL");
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
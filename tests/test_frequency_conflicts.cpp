@@ -0,0 +1,109 @@
+// AutoMixer frequency conflict resolution: a track that masks another
+// track's dominant range gets a cut there, the dominant track keeps it, no
+// band ever boosts, and disabling dynamic EQ adds no bands. The predicted
+// per-band cascade response used for prediction must match the Equalizer's
+// own magnitude response.
+
+#include "dsp/auto_mixer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+
+AudioBuffer makeTones(const std::vector<std::pair<float, float>>& tones, size_t numSamples) {
+    AudioBuffer track(1, numSamples);
+    float* data = track.getChannelData(0);
+    for (size_t i = 0; i < numSamples; ++i) {
+        float t = static_cast<float>(i) / kSampleRate;
+        for (const auto& [frequency, amplitude] : tones) {
+            data[i] += amplitude * std::sin(2.0f * static_cast<float>(M_PI) * frequency * t);
+        }
+    }
+    return track;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok) {
+        failures += ok ? 0 : 1;
+        std::printf("%-24s %s\n", name, ok ? "ok" : "FAIL");
+    };
+    
+    // Track 0 owns 1 kHz; track 1 owns 125 Hz but also puts energy at 1 kHz
+    std::vector<AudioBuffer> tracks;
+    tracks.push_back(makeTones({{1000.0f, 0.5f}}, 48000));
+    tracks.push_back(makeTones({{125.0f, 0.5f}, {1000.0f, 0.1f}}, 48000));
+    
+    AutoMixerSettings settings;
+    settings.sampleRate = kSampleRate;
+    AutoMixer mixer(settings);
+    AutoMixer::MixParameters params = mixer.analyzeTracks(tracks);
+    
+    const auto& dominant = params.trackEQs[0];
+    const auto& masking = params.trackEQs[1];
+    bool cutAtConflict = masking.size() == 1 && masking[0].frequency == 1000.0f &&
+                         masking[0].gain < 0.0f;
+    check("masking track cut", cutAtConflict);
+    if (!masking.empty()) {
+        std::printf("  band %.0f Hz %.1f dB\n", masking[0].frequency, masking[0].gain);
+    }
+    
+    bool dominantKept = true;
+    for (const EQBand& band : dominant) {
+        dominantKept = dominantKept && band.frequency != 1000.0f;
+    }
+    check("dominant range kept", dominantKept);
+    
+    bool noBoosts = true;
+    for (const auto& bands : params.trackEQs) {
+        noBoosts = noBoosts && bands.size() <= 1;
+        for (const EQBand& band : bands) {
+            noBoosts = noBoosts && band.gain < 0.0f;
+        }
+    }
+    check("cuts only, one per track", noBoosts);
+    
+    settings.enableDynamicEQ = false;
+    AutoMixer plain(settings);
+    AutoMixer::MixParameters plainParams = plain.analyzeTracks(tracks);
+    bool none = plainParams.trackEQs[0].empty() && plainParams.trackEQs[1].empty();
+    check("dynamic EQ off", none);
+    
+    // Prediction uses the same cascade response as the Equalizer
+    {
+        EQBand band;
+        band.frequency = 1000.0f;
+        band.gain = -3.0f;
+        band.q = 1.0f;
+        Equalizer eq;
+        eq.prepare(kSampleRate, 0);
+        eq.setBand(0, band);
+        
+        std::vector<float> frequencies;
+        for (float f = 20.0f; f < 20000.0f; f *= 1.1f) {
+            frequencies.push_back(f);
+        }
+        std::vector<float> fromEq(frequencies.size());
+        eq.computeMagnitudeResponse(frequencies.data(), fromEq.data(), frequencies.size());
+        
+        BiquadCoeffs coeffs = Equalizer::calculateCoeffs(band, kSampleRate);
+        std::vector<float> direct(frequencies.size());
+        computeCascadeMagnitude(&coeffs, 1, kSampleRate, frequencies.data(), direct.data(),
+                                frequencies.size());
+        float maxErr = 0.0f;
+        for (size_t i = 0; i < frequencies.size(); ++i) {
+            maxErr = std::max(maxErr, std::abs(fromEq[i] - direct[i]));
+        }
+        check("cascade response", maxErr < 1e-5f);
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
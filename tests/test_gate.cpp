@@ -0,0 +1,126 @@
+// Gate: opens on signal above the threshold, stays open inside the
+// hysteresis band and for the hold time, then closes down to the range
+// floor; blocks spent at the floor are reported as skip hints and the gain
+// never exceeds unity. Skipping dead air through a silence index matches the
+// full render.
+
+#include "effects/gate.h"
+#include "core/silence_index.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+
+void appendTone(std::vector<float>& signal, float levelDb, size_t numSamples) {
+    const float amplitude = std::pow(10.0f, levelDb / 20.0f);
+    const size_t start = signal.size();
+    for (size_t i = 0; i < numSamples; ++i) {
+        signal.push_back(amplitude * std::sin(2.0f * static_cast<float>(M_PI) * 440.0f *
+                                              static_cast<float>(start + i) / kSampleRate));
+    }
+}
+
+float gainDbAt(const std::vector<float>& in, const std::vector<float>& out, size_t center) {
+    float inPeak = 0.0f, outPeak = 0.0f;
+    for (size_t i = center - 200; i < center + 200; ++i) {
+        inPeak = std::max(inPeak, std::abs(in[i]));
+        outPeak = std::max(outPeak, std::abs(out[i]));
+    }
+    return 20.0f * std::log10(outPeak / inPeak);
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok, float value) {
+        failures += ok ? 0 : 1;
+        std::printf("%-22s %10.2f  %s\n", name, value, ok ? "ok" : "FAIL");
+    };
+
+    // Loud, then inside the hysteresis band, then below it, then silence
+    GateSettings settings;
+    settings.threshold = -40.0f;
+    settings.hysteresis = 6.0f;
+    settings.hold = 50.0f;
+    std::vector<float> input;
+    appendTone(input, -20.0f, 24000);   // 0.0 - 0.5 s: open
+    appendTone(input, -43.0f, 24000);   // 0.5 - 1.0 s: between thresholds, stays open
+    appendTone(input, -60.0f, 48000);   // 1.0 - 2.0 s: closes after the hold
+    input.resize(input.size() + 48000, 0.0f);  // 2.0 - 3.0 s: silence
+
+    Gate gate(settings);
+    gate.prepare(kSampleRate, 512);
+    std::vector<float> output = input;
+    std::vector<uint8_t> closed;
+    for (size_t pos = 0; pos < output.size(); pos += 512) {
+        const size_t n = std::min<size_t>(512, output.size() - pos);
+        gate.process(&output[pos], n);
+        const auto& hints = gate.getClosedBlocks();
+        closed.insert(closed.end(), hints.begin(), hints.end());
+    }
+
+    check("open gain (dB)", std::abs(gainDbAt(input, output, 12000)) < 0.01f, gainDbAt(input, output, 12000));
+    check("hysteresis gain (dB)", std::abs(gainDbAt(input, output, 36000)) < 0.01f, gainDbAt(input, output, 36000));
+    // Just past the transition, the hold keeps the gate open
+    check("hold gain (dB)", gainDbAt(input, output, 48000 + 1000) > -1.0f, gainDbAt(input, output, 48000 + 1000));
+    // -60 dB is 20 dB below the threshold; 10:1 expansion reaches the floor
+    check("closed gain (dB)", gainDbAt(input, output, 96000 - 4000) < -79.0f, gainDbAt(input, output, 96000 - 4000));
+
+    bool neverAbove = true;
+    for (size_t i = 0; i < input.size(); ++i) {
+        neverAbove = neverAbove && std::abs(output[i]) <= std::abs(input[i]);
+    }
+    check("gain <= unity", neverAbove, 0.0f);
+
+    // Hints: with 512-sample calls, two 256-sample hint blocks per call
+    auto closedAt = [&](size_t sample) { return closed[sample / Gate::kHintBlockSize] != 0; };
+    bool hintsOk = !closedAt(12000) && !closedAt(36000) && closedAt(96000 - 4000) && closedAt(120000);
+    check("skip hints", hintsOk, 0.0f);
+
+    // A fresh gate on silence reports every block closed
+    {
+        Gate silent(settings);
+        silent.prepare(kSampleRate, 4096);
+        std::vector<float> zeros(3000, 0.0f);
+        silent.process(zeros.data(), zeros.size());
+        const auto& hints = silent.getClosedBlocks();
+        bool all = hints.size() == (3000 + Gate::kHintBlockSize - 1) / Gate::kHintBlockSize &&
+                   std::all_of(hints.begin(), hints.end(), [](uint8_t h) { return h != 0; });
+        check("silence closed", all, static_cast<float>(hints.size()));
+    }
+
+    // With a silence index the dead air is zeroed without running the
+    // detector; output and hints match the full render, including the
+    // reopening after the silence
+    {
+        std::vector<float> reopen = input;
+        appendTone(reopen, -20.0f, 12000);
+        std::vector<float> full = reopen, skipped = reopen;
+        float* fullData = full.data();
+        float* skippedData = skipped.data();
+        
+        Gate reference(settings), hinted(settings);
+        reference.prepare(kSampleRate, 4096);
+        hinted.prepare(kSampleRate, 4096);
+        reference.process(&fullData, 1, full.size());
+        SilenceIndex silence(&skippedData, 1, skipped.size());
+        hinted.process(&skippedData, 1, skipped.size(), &silence);
+        
+        float maxError = 0.0f;
+        for (size_t i = 0; i < full.size(); ++i) {
+            maxError = std::max(maxError, std::abs(full[i] - skipped[i]));
+        }
+        check("silence index", maxError < 1e-5f &&
+                               reference.getClosedBlocks() == hinted.getClosedBlocks(),
+              maxError * 1e6f);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
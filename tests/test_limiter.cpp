@@ -0,0 +1,105 @@
+// Limiter: output stays under the ceiling for hot material, quiet material
+// passes through unchanged apart from the reported latency.
+
+#include "effects/limiter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+
+// Peak of the 4x band-limited reconstruction, by dense sinc interpolation
+float truePeak(const std::vector<float>& x) {
+    float peak = 0.0f;
+    for (size_t n = 32; n + 32 < x.size(); ++n) {
+        for (int p = 0; p < 4; ++p) {
+            double t = p / 4.0;
+            double y = 0.0;
+            for (int k = -32; k <= 32; ++k) {
+                double d = t - k;
+                double sinc = d == 0.0 ? 1.0 : std::sin(M_PI * d) / (M_PI * d);
+                double w = 0.5 * (1.0 + std::cos(M_PI * d / 33.0));
+                y += x[n + k] * sinc * w;
+            }
+            peak = std::max(peak, static_cast<float>(std::abs(y)));
+        }
+    }
+    return peak;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    int failures = 0;
+
+    // Hot stereo material: noise (rolled off towards Nyquist, like program
+    // material) with +12 dB bursts, and a tone with large intersample peaks
+    const size_t n = 48000;
+    std::vector<float> left(n), right(n);
+    float previous = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float burst = (i / 4800) % 3 == 1 ? 4.0f : 1.0f;
+        float noise = dist(rng);
+        left[i] = (noise + previous) * burst;
+        previous = noise;
+        right[i] = 1.5f * std::sin(static_cast<float>(i) * 0.5f * static_cast<float>(M_PI) + 0.785f);
+    }
+
+    for (bool truePeakMode : {false, true}) {
+        LimiterSettings settings;
+        settings.ceiling = -1.0f;
+        settings.truePeak = truePeakMode;
+        Limiter limiter(settings);
+        limiter.prepare(kSampleRate, 512, 2);
+
+        std::vector<float> l = left, r = right;
+        for (size_t pos = 0; pos < n; pos += 500) {
+            float* channels[] = {l.data() + pos, r.data() + pos};
+            limiter.process(channels, 2, std::min<size_t>(500, n - pos));
+        }
+
+        const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+        float samplePeak = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            samplePeak = std::max({samplePeak, std::abs(l[i]), std::abs(r[i])});
+        }
+        float interPeak = std::max(truePeak(l), truePeak(r));
+
+        // Sample peaks are a hard guarantee; true peaks are estimated
+        bool ok = samplePeak <= ceiling && (!truePeakMode || interPeak <= ceiling * 1.02f);
+        failures += ok ? 0 : 1;
+        std::printf("%-10s sample peak %.4f  true peak %.4f  ceiling %.4f  %s\n",
+                    truePeakMode ? "true peak" : "sample", samplePeak, interPeak, ceiling, ok ? "ok" : "FAIL");
+    }
+
+    // Quiet signal: exact delayed copy
+    {
+        Limiter limiter;
+        limiter.prepare(kSampleRate, 256, 1);
+        std::vector<float> quiet(n);
+        for (auto& s : quiet) {
+            s = dist(rng) * 0.5f;
+        }
+        std::vector<float> out = quiet;
+        limiter.process(out.data(), n);
+
+        const size_t latency = limiter.getLatency();
+        bool exact = true;
+        for (size_t i = 0; i < n; ++i) {
+            float expected = i >= latency ? quiet[i - latency] : 0.0f;
+            exact = exact && out[i] == expected;
+        }
+        failures += exact ? 0 : 1;
+        std::printf("%-10s latency %zu  %s\n", "quiet", latency, exact ? "ok" : "FAIL");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
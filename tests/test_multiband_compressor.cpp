@@ -0,0 +1,133 @@
+// MultibandCompressor: with unity-gain bands the Linkwitz-Riley tree must sum
+// to the cascade of crossover allpasses (flat magnitude), compression must
+// stay within the band that exceeds its threshold, and unsupported band
+// counts must be rejected. Zero-channel and empty calls are no-ops.
+
+#include "effects/multiband_compressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+
+// The LR4 lowpass + highpass sum, as a double precision allpass
+std::vector<double> allpassChain(const std::vector<float>& crossovers, const std::vector<double>& input) {
+    std::vector<double> y = input;
+    for (float frequency : crossovers) {
+        double omega = 2.0 * M_PI * frequency / kSampleRate;
+        double alpha = std::sin(omega) / (2.0 * std::sqrt(0.5));
+        double a0 = 1.0 + alpha;
+        double b0 = (1.0 - alpha) / a0, b1 = -2.0 * std::cos(omega) / a0, b2 = 1.0;
+        double s1 = 0.0, s2 = 0.0;
+        for (double& v : y) {
+            double out = b0 * v + s1;
+            s1 = b1 * v - b1 * out + s2;
+            s2 = b2 * v - b0 * out;
+            v = out;
+        }
+    }
+    return y;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    // Unity bands: the output is the input through the crossover allpasses
+    std::printf("%-12s %12s\n", "bands", "max error");
+    for (size_t numBands = MultibandCompressor::kMinBands; numBands <= MultibandCompressor::kMaxBands; ++numBands) {
+        MultibandCompressor multiband(numBands);
+        multiband.prepare(kSampleRate, 256, 1);
+        CompressorSettings unity;
+        unity.ratio = 1.0f;
+        for (size_t b = 0; b < numBands; ++b) {
+            multiband.setBandSettings(b, unity);
+        }
+
+        std::vector<float> impulse(8192, 0.0f);
+        impulse[0] = 0.5f;
+        std::vector<double> expected = allpassChain(
+            [&] {
+                std::vector<float> f;
+                for (size_t k = 0; k + 1 < numBands; ++k) {
+                    f.push_back(multiband.getCrossover(k));
+                }
+                return f;
+            }(),
+            std::vector<double>(impulse.begin(), impulse.end()));
+
+        // Uneven blocks, some larger than the prepared block size
+        const size_t chunks[] = {1, 100, 256, 700, 33};
+        for (size_t pos = 0, c = 0; pos < impulse.size(); ++c) {
+            size_t n = std::min(chunks[c % 5], impulse.size() - pos);
+            multiband.process(&impulse[pos], n);
+            pos += n;
+        }
+
+        double maxErr = 0.0;
+        for (size_t i = 0; i < impulse.size(); ++i) {
+            maxErr = std::max(maxErr, std::abs(impulse[i] - expected[i]));
+        }
+        bool ok = maxErr < 1e-5;
+        failures += ok ? 0 : 1;
+        std::printf("%-12zu %12.2e  %s\n", numBands, maxErr, ok ? "ok" : "FAIL");
+    }
+
+    // A loud bass tone under a quiet treble tone compresses the low band only
+    {
+        MultibandCompressor multiband(3);
+        multiband.prepare(kSampleRate, 512, 2);
+        std::vector<float> left(48000);
+        for (size_t i = 0; i < left.size(); ++i) {
+            float t = static_cast<float>(i) / kSampleRate;
+            left[i] = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * 60.0f * t) +
+                      0.01f * std::sin(2.0f * static_cast<float>(M_PI) * 6000.0f * t);
+        }
+        std::vector<float> right = left;
+        float* channels[] = {left.data(), right.data()};
+        multiband.process(channels, 2, left.size());
+
+        float low = multiband.getGainReduction(0, 1);
+        float high = multiband.getGainReduction(2, 1);
+        bool same = left == right;
+        bool ok = low < -3.0f && high > -0.01f && same;
+        failures += ok ? 0 : 1;
+        std::printf("%-12s low %.2f dB, high %.2f dB, channels %s  %s\n", "selective", low, high,
+                    same ? "same" : "DIFF", ok ? "ok" : "FAIL");
+    }
+
+    // Prepared for no channels: empty calls are no-ops, a later call grows it
+    {
+        MultibandCompressor multiband(3);
+        multiband.prepare(kSampleRate, 256, 0);
+        multiband.process(nullptr, 0, 512);
+        std::vector<float> mono(512, 0.25f);
+        float* channels[] = {mono.data()};
+        multiband.process(channels, 1, 0);
+        multiband.process(channels, 1, mono.size());
+        bool ok = std::isfinite(mono.back());
+        failures += ok ? 0 : 1;
+        std::printf("%-12s %12s  %s\n", "0 channels", ok ? "handled" : "broken", ok ? "ok" : "FAIL");
+    }
+
+    // Band counts outside 3..5 are rejected
+    {
+        bool threw = false;
+        try {
+            MultibandCompressor multiband(2);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        failures += threw ? 0 : 1;
+        std::printf("%-12s %12s  %s\n", "2 bands", threw ? "rejected" : "accepted", threw ? "ok" : "FAIL");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// Sample conversion: every format, planar and interleaved, for several
+// channel counts and lengths that are not multiples of the vector width,
+// matches a scalar reference exactly.
+
+#include "core/sample_conversion.h"
+#include <cstdio>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+template <typename T>
+float reference(T value) {
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return static_cast<float>(value) * (1.0f / 32768.0f);
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return static_cast<float>(value) * (1.0f / 2147483648.0f);
+    } else {
+        return static_cast<float>(value);
+    }
+}
+
+template <typename T>
+bool checkFormat(SampleFormat format, std::mt19937& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t numChannels : {1, 2, 3, 6, 80}) {
+        for (size_t numFrames : {0, 1, 7, 8, 61, 5000}) {
+            std::vector<T> source(numChannels * numFrames);
+            for (auto& v : source) {
+                const double x = dist(rng);
+                if constexpr (std::is_same_v<T, int16_t>) {
+                    v = static_cast<T>(x * 32767.0);
+                } else if constexpr (std::is_same_v<T, int32_t>) {
+                    v = static_cast<T>(x * 2147483647.0);
+                } else {
+                    v = static_cast<T>(x);
+                }
+            }
+            
+            for (bool interleaved : {false, true}) {
+                std::vector<std::vector<float>> planar(numChannels, std::vector<float>(numFrames));
+                std::vector<float*> dst(numChannels);
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    dst[ch] = planar[ch].data();
+                }
+                convertToPlanar(source.data(), format, numChannels, numFrames, interleaved, dst.data());
+                
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    for (size_t i = 0; i < numFrames; ++i) {
+                        const size_t index = interleaved ? i * numChannels + ch : ch * numFrames + i;
+                        if (planar[ch][i] != reference(source[index])) {
+                            std::printf("mismatch: %zu ch, %zu frames, %s, ch %zu frame %zu\n",
+                                        numChannels, numFrames,
+                                        interleaved ? "interleaved" : "planar", ch, i);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(3);
+    int failures = 0;
+    auto check = [&](const char* name, bool ok) {
+        failures += ok ? 0 : 1;
+        std::printf("%-10s %s\n", name, ok ? "ok" : "FAIL");
+    };
+    
+    check("float32", checkFormat<float>(SampleFormat::Float32, rng));
+    check("float64", checkFormat<double>(SampleFormat::Float64, rng));
+    check("int16", checkFormat<int16_t>(SampleFormat::Int16, rng));
+    check("int32", checkFormat<int32_t>(SampleFormat::Int32, rng));
+    
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+// Shared-memory AudioBuffers: a second mapping and a forked child see the
+// creator's samples and writes, copies are private, the name is released
+// with the last reference in any process, a buffer handed over by a child
+// that has exited can still be adopted, and bad names, taken names and
+// shapes whose byte size overflows fail.
+
+#include "core/shared_memory.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace audio_practice;
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok) {
+        failures += ok ? 0 : 1;
+        std::printf("%-26s %s\n", name, ok ? "ok" : "FAIL");
+    };
+
+    const std::string name = "/audio_practice_test_" + std::to_string(getpid());
+    constexpr size_t kChannels = 2;
+    constexpr size_t kSamples = 1000;
+
+    {
+        AudioBuffer shared = createSharedAudioBuffer(name, kChannels, kSamples);
+        auto segment = getSharedSegment(shared);
+        check("name", segment && segment->getName() == name);
+        for (size_t ch = 0; ch < kChannels; ++ch) {
+            for (size_t i = 0; i < kSamples; ++i) {
+                shared.getChannelData(ch)[i] = static_cast<float>(ch * kSamples + i);
+            }
+        }
+
+        // A second mapping reads the same samples and its writes show through
+        AudioBuffer attached = openSharedAudioBuffer(name.substr(1));
+        bool sameShape = attached.getNumChannels() == kChannels &&
+                         attached.getNumSamples() == kSamples;
+        check("attach shape", sameShape);
+        check("attach data", sameShape && attached.getChannelData(1)[10] == 1010.0f);
+        attached.getChannelData(0)[5] = -1.0f;
+        check("write through", shared.getChannelData(0)[5] == -1.0f);
+
+        // Copies are private storage
+        AudioBuffer copy(shared);
+        copy.getChannelData(0)[0] = 42.0f;
+        check("copy is private", !getSharedSegment(copy) && shared.getChannelData(0)[0] == 0.0f);
+
+        // A view of part of the segment is not the segment itself
+        {
+            AudioBuffer view(shared.getChannelData(1), 1, kSamples, shared.getOwner());
+            check("partial view", !getSharedSegment(view));
+        }
+
+        // Another process attaches by name and writes back
+        pid_t child = fork();
+        if (child == 0) {
+            bool ok = false;
+            {
+                AudioBuffer remote = openSharedAudioBuffer(name);
+                ok = remote.getChannelData(1)[999] == 1999.0f;
+                remote.getChannelData(1)[0] = 7.0f;
+            }
+            _exit(ok ? 0 : 1);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        check("child process", WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                               shared.getChannelData(1)[0] == 7.0f);
+
+        bool taken = false;
+        try {
+            createSharedAudioBuffer(name, 1, 1);
+        } catch (const std::system_error&) {
+            taken = true;
+        }
+        check("name taken", taken);
+
+        // Moving keeps the segment; the moved-to buffer still owns the name
+        AudioBuffer moved = std::move(shared);
+        check("move", getSharedSegment(moved) == segment && moved.getChannelData(1)[10] == 1010.0f);
+
+        // The attached mapping outlives the creator's buffer and keeps the name
+        moved = AudioBuffer(1, 1);
+        segment.reset();
+        check("mapping outlives creator", attached.getChannelData(1)[10] == 1010.0f &&
+                                          getSharedSegment(attached)->getReferenceCount() == 1);
+    }
+
+    bool released = false;
+    try {
+        openSharedAudioBuffer(name);
+    } catch (const std::system_error&) {
+        released = true;
+    }
+    check("name released", released);
+
+    // A child creates a buffer, hands a reference over (as pickling does) and
+    // exits before the parent attaches
+    pid_t worker = fork();
+    if (worker == 0) {
+        {
+            AudioBuffer result = createSharedAudioBuffer(name, 1, kSamples);
+            result.getChannelData(0)[kSamples - 1] = 3.0f;
+            getSharedSegment(result)->retain();
+        }
+        _exit(0);
+    }
+    int workerStatus = 0;
+    waitpid(worker, &workerStatus, 0);
+    bool adopted = false;
+    try {
+        AudioBuffer result = adoptSharedAudioBuffer(name);
+        adopted = result.getChannelData(0)[kSamples - 1] == 3.0f &&
+                  getSharedSegment(result)->getReferenceCount() == 1;
+    } catch (const std::system_error&) {
+    }
+    check("handoff from child", WIFEXITED(workerStatus) && adopted);
+
+    bool handoffReleased = false;
+    try {
+        openSharedAudioBuffer(name);
+    } catch (const std::system_error&) {
+        handoffReleased = true;
+    }
+    check("handoff released", handoffReleased);
+
+    bool invalid = false;
+    try {
+        openSharedAudioBuffer("a/b");
+    } catch (const std::invalid_argument&) {
+        invalid = true;
+    }
+    check("invalid name", invalid);
+
+    bool tooLarge = false;
+    try {
+        createSharedAudioBuffer(name, SIZE_MAX / 2, 3);
+    } catch (const std::length_error&) {
+        tooLarge = true;
+    }
+    check("size overflow", tooLarge);
+
+    // A header whose shape wraps around when multiplied is rejected on open
+    {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        uint64_t header[8] = {0x0000000241504142ull, SIZE_MAX / 2, 8};
+        bool written = fd >= 0 && write(fd, header, sizeof(header)) == sizeof(header);
+        if (fd >= 0) {
+            close(fd);
+        }
+        bool rejected = false;
+        try {
+            openSharedAudioBuffer(name);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        shm_unlink(name.c_str());
+        check("corrupt shape", written && rejected);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// SilenceIndex: silent blocks, merged silent regions, the complementary
+// active regions and O(1) range queries agree with a brute-force scan,
+// including a partial final block and a single loud sample in one channel;
+// blocks marked silent afterwards merge into the regions.
+
+#include "core/silence_index.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace audio_practice;
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok, float value) {
+        failures += ok ? 0 : 1;
+        std::printf("%-22s %10.2f  %s\n", name, value, ok ? "ok" : "FAIL");
+    };
+
+    // 2 channels, 10.5 blocks of 256: tone in blocks 2-3, one click in the
+    // right channel of block 7, low noise below the threshold elsewhere
+    constexpr size_t kBlock = 256;
+    constexpr size_t kSamples = 10 * kBlock + 128;
+    AudioBuffer buffer(2, kSamples);
+    for (size_t ch = 0; ch < 2; ++ch) {
+        float* data = buffer.getChannelData(ch);
+        for (size_t i = 0; i < kSamples; ++i) {
+            data[i] = 1e-5f * std::sin(0.1f * static_cast<float>(i));
+        }
+        for (size_t i = 2 * kBlock; i < 4 * kBlock; ++i) {
+            data[i] = 0.5f * std::sin(0.05f * static_cast<float>(i));
+        }
+    }
+    buffer.getChannelData(1)[7 * kBlock + 100] = -0.01f;
+
+    SilenceIndex index(buffer);
+    check("blocks", index.getNumBlocks() == 11, static_cast<float>(index.getNumBlocks()));
+    check("silent blocks", index.getNumSilentBlocks() == 8,
+          static_cast<float>(index.getNumSilentBlocks()));
+
+    const bool expected[11] = {true, true, false, false, true, true, true, false, true, true, true};
+    bool blocksOk = true;
+    for (size_t b = 0; b < 11; ++b) {
+        blocksOk = blocksOk && index.isSilentBlock(b) == expected[b];
+    }
+    check("block flags", blocksOk, 0.0f);
+
+    // Silent runs: [0, 512), [1024, 1792), [2048, end)
+    const auto& regions = index.getSilentRegions();
+    const bool regionsOk = regions.size() == 3 &&
+                           regions[0].start == 0 && regions[0].length == 2 * kBlock &&
+                           regions[1].start == 4 * kBlock && regions[1].length == 3 * kBlock &&
+                           regions[2].start == 8 * kBlock &&
+                           regions[2].length == kSamples - 8 * kBlock;
+    check("silent regions", regionsOk, static_cast<float>(regions.size()));
+
+    // Active runs cover exactly the rest
+    size_t activeSamples = 0, activeRuns = 0;
+    index.forEachActiveRegion([&](size_t, size_t length) {
+        activeSamples += length;
+        ++activeRuns;
+    });
+    check("active regions", activeRuns == 2 && activeSamples == 3 * kBlock,
+          static_cast<float>(activeSamples));
+
+    // Range queries against the block flags
+    bool rangesOk = true;
+    for (size_t start = 0; start < kSamples + kBlock; start += 37) {
+        for (size_t length : {1ul, 100ul, 300ul, 1000ul}) {
+            bool brute = true;
+            for (size_t i = start; i < std::min(start + length, kSamples); ++i) {
+                brute = brute && expected[i / kBlock];
+            }
+            rangesOk = rangesOk && index.isSilent(start, length) == brute;
+        }
+    }
+    check("range queries", rangesOk, 0.0f);
+
+    // Marking block 7 (the click) silent joins the last two runs
+    std::vector<uint8_t> closed(11, 0);
+    closed[7] = 1;
+    index.markSilent(closed);
+    const auto& merged = index.getSilentRegions();
+    check("mark silent", index.getNumSilentBlocks() == 9 && merged.size() == 2 &&
+                         merged[1].start == 4 * kBlock &&
+                         merged[1].length == kSamples - 4 * kBlock,
+          static_cast<float>(index.getNumSilentBlocks()));
+
+    // Everything is silent with a threshold above the tone
+    SilenceIndex loose(buffer, 1.0f);
+    check("loose threshold", loose.getNumSilentBlocks() == 11 && loose.isSilent(0, kSamples),
+          static_cast<float>(loose.getNumSilentBlocks()));
+
+    return failures == 0 ? 0 : 1;
+}
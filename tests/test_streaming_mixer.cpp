@@ -0,0 +1,129 @@
+// StreamingMixer: with the parameters AutoMixer derived, streaming a session
+// in small blocks reproduces the offline mix delayed by getLatency(), voice
+// ducking included; without parameters, the running loudness estimate
+// brings quiet and loud tracks towards the same level.
+//
+// Offline, the ducker's sidechain starts lookahead samples into the voice;
+// streaming, it also sees the voice's first lookahead samples, so the two
+// only agree once that start-up difference has been released.
+
+#include "dsp/streaming_mixer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace audio_practice;
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kSettleSamples = 24000;
+
+AudioBuffer makeTrack(size_t numChannels, size_t numSamples, float level, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, level);
+    AudioBuffer track(numChannels, numSamples);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        float* data = track.getChannelData(ch);
+        for (size_t i = 0; i < numSamples; ++i) {
+            // Bursts so the ducker and bus compressor move
+            const float envelope = (i / 12000) % 2 ? 1.0f : 0.3f;
+            data[i] = noise(rng) * envelope;
+        }
+    }
+    return track;
+}
+
+// Stream tracks through the mixer in blocks of blockSize, returning the
+// output including getLatency() samples of flushed tail
+AudioBuffer stream(StreamingMixer& mixer, const std::vector<AudioBuffer>& tracks,
+                   size_t blockSize) {
+    const size_t numSamples = tracks[0].getNumSamples();
+    const size_t total = numSamples + mixer.getLatency();
+    AudioBuffer output(2, total);
+    
+    std::vector<AudioBuffer> padded;
+    for (const AudioBuffer& track : tracks) {
+        AudioBuffer copy(track.getNumChannels(), total);
+        for (size_t ch = 0; ch < track.getNumChannels(); ++ch) {
+            std::copy(track.getChannelData(ch), track.getChannelData(ch) + numSamples,
+                      copy.getChannelData(ch));
+        }
+        padded.push_back(std::move(copy));
+    }
+    
+    std::vector<std::vector<const float*>> channels(padded.size());
+    std::vector<const float* const*> trackPointers(padded.size());
+    for (size_t pos = 0; pos < total; pos += blockSize) {
+        const size_t n = std::min(blockSize, total - pos);
+        for (size_t t = 0; t < padded.size(); ++t) {
+            channels[t].clear();
+            for (size_t ch = 0; ch < padded[t].getNumChannels(); ++ch) {
+                channels[t].push_back(padded[t].getChannelData(ch) + pos);
+            }
+            trackPointers[t] = channels[t].data();
+        }
+        float* out[2] = {output.getChannelData(0) + pos, output.getChannelData(1) + pos};
+        mixer.process(trackPointers.data(), out, n);
+    }
+    return output;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok, float value) {
+        failures += ok ? 0 : 1;
+        std::printf("%-22s %10.2e  %s\n", name, value, ok ? "ok" : "FAIL");
+    };
+    
+    const size_t numSamples = 96000;
+    std::vector<AudioBuffer> tracks;
+    tracks.push_back(makeTrack(1, numSamples, 0.2f, 1));   // voice
+    tracks.push_back(makeTrack(2, numSamples, 0.05f, 2));  // stereo music
+    tracks.push_back(makeTrack(1, numSamples, 0.3f, 3));
+    
+    AutoMixerSettings settings;
+    settings.sampleRate = kSampleRate;
+    settings.voiceTracks = {0};
+    
+    // Offline reference and its parameters
+    AutoMixer offline(settings);
+    AutoMixer::MixParameters params = offline.analyzeTracks(tracks);
+    AudioBuffer reference = offline.process(tracks);
+    
+    for (size_t blockSize : {64, 500, 4096}) {
+        StreamingMixer mixer(settings, {1, 2, 1}, 512);
+        mixer.setMixParameters(params);
+        AudioBuffer streamed = stream(mixer, tracks, blockSize);
+        
+        const size_t latency = mixer.getLatency();
+        float err = 0.0f;
+        for (size_t ch = 0; ch < 2; ++ch) {
+            for (size_t i = kSettleSamples; i < numSamples; ++i) {
+                err = std::max(err, std::abs(streamed.getChannelData(ch)[i + latency] -
+                                             reference.getChannelData(ch)[i]));
+            }
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "offline match /%zu", blockSize);
+        check(name, err < 1e-4f, err);
+    }
+    
+    // Running loudness: 30 dB apart at the input, close after a few seconds
+    std::vector<AudioBuffer> uneven;
+    uneven.push_back(makeTrack(1, 5 * 48000, 0.3f, 4));
+    uneven.push_back(makeTrack(1, 5 * 48000, 0.01f, 5));
+    AutoMixerSettings adaptive = settings;
+    adaptive.voiceTracks.clear();
+    adaptive.maxGainReduction = 40.0f;
+    StreamingMixer mixer(adaptive, {1, 1}, 1024);
+    stream(mixer, uneven, 1024);
+    const float balance = 20.0f * std::log10(mixer.getTrackGain(1) / mixer.getTrackGain(0));
+    check("running loudness", std::abs(balance - 29.5f) < 1.0f, balance);
+    
+    return failures == 0 ? 0 : 1;
+}